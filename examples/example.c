@@ -184,41 +184,29 @@ actor_error_t main_process(actor_process_t main) {
         actor_send(main, main->nid, pong, ACTOR_TYPE_PROCESSID, &ping, sizeof(actor_process_id_t));
         actor_send(main, main->nid, ping, ACTOR_TYPE_PROCESSID, &pong, sizeof(actor_process_id_t));
 
-        // get result of both processes
+        // get result of both processes, other messages stay in the mailbox
         for (int i = 0; i < 2; i++) {
-            // message loop
-            while (true) {
-                // get error message
-                actor_message_t message = NULL;
-                error = actor_receive(main, &message, 2.0);
-
-                // check success
-                if (error != ACTOR_SUCCESS) {
-                    return error;
-                }
-
-                // check message type
-                if (message->type != ACTOR_TYPE_ERROR_MESSAGE) {
-                    // cleanup
-                    actor_message_release(&message);
-
-                    continue;
-                }
-
-                // cast to error message
-                actor_process_error_message_t error_message =
-                    (actor_process_error_message_t)message->data;
-
-                // check error
-                if (error_message->error != ACTOR_SUCCESS) {
-                    // cleanup
-                    actor_message_release(&message);
-
-                    return error_message->error;
-                }
-
-                // exit loop
-                break;
+            // get error message
+            actor_message_t message = NULL;
+            error = actor_receive_type(main, &message, ACTOR_TYPE_ERROR_MESSAGE,
+                2.0);
+
+            // check success
+            if (error != ACTOR_SUCCESS) {
+                return error;
+            }
+
+            // cast to error message
+            actor_process_error_message_t error_message =
+                (actor_process_error_message_t)message->data;
+            error = error_message->error;
+
+            // cleanup
+            actor_message_release(&message);
+
+            // check error
+            if (error != ACTOR_SUCCESS) {
+                return error;
             }
         }
 
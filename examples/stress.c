@@ -0,0 +1,210 @@
+// libactor
+//
+// Implementation of an erlang style actor model using libdispatch
+// Copyright (C) 2012  Patrik Gebhardt
+// Contact: patrik.gebhardt@rub.de
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include "../include/actor.h"
+
+// number of producer processes
+#define PRODUCER_COUNT (8)
+
+// number of messages sent by each producer
+#define MESSAGE_COUNT (10000)
+
+// mailbox capacity of bounded consumer
+#define MAILBOX_CAPACITY (64)
+
+actor_error_t producer_function(actor_process_t self,
+    actor_process_id_t consumer, int producer) {
+    // error
+    actor_error_t error = ACTOR_SUCCESS;
+
+    // send numbered messages
+    for (int sequence = 0; sequence < MESSAGE_COUNT; sequence++) {
+        int data[2] = { producer, sequence };
+        error = actor_send(self, self->nid, consumer, ACTOR_TYPE_INT, data,
+            sizeof(data));
+
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            return error;
+        }
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+actor_error_t consumer_function(actor_process_t self) {
+    // error
+    actor_error_t error = ACTOR_SUCCESS;
+
+    // next expected sequence number of each producer
+    int expected[PRODUCER_COUNT] = { 0 };
+
+    for (int i = 0; i < PRODUCER_COUNT * MESSAGE_COUNT; i++) {
+        // receive message, every 16th one selective from first producer
+        actor_message_t message = NULL;
+        if ((i % 16 == 0) && (expected[0] < MESSAGE_COUNT)) {
+            error = actor_receive_match(self, &message,
+                ^bool(actor_message_t candidate) {
+                    return ((int*)candidate->data)[0] == 0;
+                }, 10.0);
+        }
+        else {
+            error = actor_receive(self, &message, 10.0);
+        }
+
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            return error;
+        }
+
+        // check message
+        int* data = (int*)message->data;
+        if ((message->type != ACTOR_TYPE_INT) ||
+            (message->size != 2 * sizeof(int)) ||
+            (data[0] < 0) || (data[0] >= PRODUCER_COUNT) ||
+            (data[1] != expected[data[0]])) {
+            printf("%d.%d: message out of order!\n", self->nid, self->pid);
+
+            // cleanup
+            actor_message_release(&message);
+
+            return ACTOR_ERROR;
+        }
+        expected[data[0]]++;
+
+        // release message
+        actor_message_release(&message);
+    }
+
+    // no message may arrive twice
+    actor_message_t message = NULL;
+    if (actor_receive(self, &message, 0.1) == ACTOR_SUCCESS) {
+        printf("%d.%d: message duplicated!\n", self->nid, self->pid);
+
+        // cleanup
+        actor_message_release(&message);
+
+        return ACTOR_ERROR;
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+actor_error_t main_process(actor_process_t main) {
+    // error
+    actor_error_t error = ACTOR_SUCCESS;
+
+    // unbounded and blocking bounded mailbox
+    for (int round = 0; round < 2; round++) {
+        // spawn consumer process
+        actor_process_id_t consumer = ACTOR_INVALID_ID;
+        actor_process_function_t function = ^actor_error_t(actor_process_t self) {
+            // link to main process
+            actor_process_link(self, main->nid, main->pid);
+
+            return consumer_function(self);
+        };
+        if (round == 0) {
+            error = actor_spawn(main->node, &consumer, function);
+        }
+        else {
+            error = actor_spawn_bounded(main->node, &consumer,
+                MAILBOX_CAPACITY, ACTOR_MESSAGE_QUEUE_BLOCK, 10.0, function);
+        }
+
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            return error;
+        }
+
+        // spawn producer processes
+        for (int producer = 0; producer < PRODUCER_COUNT; producer++) {
+            error = actor_spawn(main->node, NULL,
+                ^actor_error_t(actor_process_t self) {
+                    return producer_function(self, consumer, producer);
+                });
+
+            // check success
+            if (error != ACTOR_SUCCESS) {
+                return error;
+            }
+        }
+
+        // get result of consumer
+        actor_message_t message = NULL;
+        error = actor_receive_type(main, &message, ACTOR_TYPE_ERROR_MESSAGE,
+            60.0);
+
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            return error;
+        }
+
+        // cast to error message
+        actor_process_error_message_t error_message =
+            (actor_process_error_message_t)message->data;
+        error = error_message->error;
+
+        // cleanup
+        actor_message_release(&message);
+
+        // check error
+        if (error != ACTOR_SUCCESS) {
+            return error;
+        }
+
+        printf("%d.%d: %d messages of %d producers received %s!\n", main->nid,
+            main->pid, PRODUCER_COUNT * MESSAGE_COUNT, PRODUCER_COUNT,
+            round == 0 ? "unbounded" : "bounded");
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+int main(int argc, char* argv[]) {
+    // create node
+    actor_node_t node = NULL;
+    if (actor_node_create(&node, 0, 20) != ACTOR_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+
+    // result of main process
+    __block actor_error_t result = ACTOR_ERROR;
+
+    // start main process
+    actor_spawn(node, NULL, ^actor_error_t(actor_process_t self) {
+            // call main process
+            result = main_process(self);
+
+            // print result
+            printf("main process died with result: %s!\n",
+                actor_error_string(result));
+
+            return result;
+        });
+
+    // wait for processes to complete
+    actor_node_wait_for_processes(node, 120.0);
+
+    // release node
+    actor_node_release(&node);
+
+    return result == ACTOR_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
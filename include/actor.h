@@ -22,6 +22,7 @@
 
 // standard includes
 #include <stdlib.h>
+#include <pthread.h>
 #include <dispatch/dispatch.h>
 
 // data type definitions
@@ -33,8 +34,18 @@
 // error definitions
 #include "error.h"
 
+// timer wheel
+#include "timer.h"
+
+// scheduler
+#include "scheduler.h"
+
+// compression codecs
+#include "compression.h"
+
 // actor includes
 #include "message.h"
+#include "pool.h"
 #include "node.h"
 #include "process.h"
 #include "distributer.h"
@@ -43,13 +54,87 @@
 actor_error_t actor_spawn(actor_node_t node, actor_process_id_t* pid,
     actor_process_function_t function);
 
+// spawn new process with mailbox of at most capacity messages, policy
+// decides about messages sent to a full mailbox
+actor_error_t actor_spawn_bounded(actor_node_t node, actor_process_id_t* pid,
+    actor_size_t capacity, actor_message_queue_policy_t policy,
+    actor_time_t timeout, actor_process_function_t function);
+
+// spawn new reactive process
+actor_error_t actor_spawn_reactive(actor_node_t node, actor_process_id_t* pid,
+    actor_process_handler_t handler);
+
 // message sending
 actor_error_t actor_send(actor_process_t process,
     actor_node_id_t destination_nid, actor_process_id_t destination_pid,
     actor_data_type_t type, actor_message_data_t const data, actor_size_t size);
 
+// message sending with system priority, e.g. for control and shutdown
+// messages, which are received before all queued normal messages
+actor_error_t actor_send_system(actor_process_t process,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size);
+
+// message sending after delay in seconds, without holding a thread, timer
+// may be NULL or gets a handle for actor_cancel_timer
+actor_error_t actor_send_after(actor_process_t process, actor_time_t delay,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size,
+    actor_node_timer_t* timer);
+
+// periodic message sending, e.g. for heartbeats, until the handle is
+// cancelled
+actor_error_t actor_send_interval(actor_process_t process, actor_time_t period,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size,
+    actor_node_timer_t* timer);
+
+// cancel delayed or periodic message and release its handle
+actor_error_t actor_cancel_timer(actor_process_t process,
+    actor_node_timer_t* timer);
+
+// message sending without copy, on success data is freed by the receiver
+// using free_function
+actor_error_t actor_send_owned(actor_process_t process,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t data, actor_size_t size,
+    actor_message_free_function_t free_function);
+
+// send message to several destinations sharing one copy of data
+actor_error_t actor_broadcast(actor_process_t process,
+    actor_message_destination_s const* destinations, actor_size_t count,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size);
+
 // message receive
 actor_error_t actor_receive(actor_process_t process, actor_message_t* message,
     actor_time_t timeout);
 
+// receive up to max messages in one operation, waits only for the first
+// message, count is set to the number of received messages
+actor_error_t actor_receive_batch(actor_process_t process,
+    actor_message_t* messages, actor_size_t max, actor_size_t* count,
+    actor_time_t timeout);
+
+// selective message receive, gets the first message matching predicate and
+// leaves all other messages in the mailbox in their order
+actor_error_t actor_receive_match(actor_process_t process,
+    actor_message_t* message, actor_message_predicate_t predicate,
+    actor_time_t timeout);
+
+// receive first message of type
+actor_error_t actor_receive_type(actor_process_t process,
+    actor_message_t* message, actor_data_type_t type, actor_time_t timeout);
+
+// send request and wait for its reply, the request carries the ids of the
+// process and a correlation id, unrelated messages stay in the mailbox,
+// a reply arriving after the timeout is received like any other message
+actor_error_t actor_call(actor_process_t process,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size,
+    actor_message_t* reply, actor_time_t timeout);
+
+// reply to request of call
+actor_error_t actor_reply(actor_process_t process, actor_message_t request,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size);
+
 #endif
@@ -0,0 +1,64 @@
+// libactor
+//
+// Implementation of an erlang style actor model using libdispatch
+// Copyright (C) 2012  Patrik Gebhardt
+// Contact: patrik.gebhardt@rub.de
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ACTOR_COMPRESSION_H
+#define ACTOR_COMPRESSION_H
+
+// compression codecs, supported codecs are exchanged as bit mask
+#define ACTOR_COMPRESSION_NONE (0x00)
+#define ACTOR_COMPRESSION_BUILTIN (0x01)
+#define ACTOR_COMPRESSION_LZ4 (0x02)
+#define ACTOR_COMPRESSION_ZSTD (0x04)
+
+// codecs of this build, the builtin codec is always available, lz4 and zstd
+// are enabled by defining ACTOR_USE_LZ4 or ACTOR_USE_ZSTD
+#ifdef ACTOR_USE_LZ4
+#define ACTOR_COMPRESSION_HAS_LZ4 (ACTOR_COMPRESSION_LZ4)
+#else
+#define ACTOR_COMPRESSION_HAS_LZ4 (0)
+#endif
+#ifdef ACTOR_USE_ZSTD
+#define ACTOR_COMPRESSION_HAS_ZSTD (ACTOR_COMPRESSION_ZSTD)
+#else
+#define ACTOR_COMPRESSION_HAS_ZSTD (0)
+#endif
+#define ACTOR_COMPRESSION_SUPPORTED (ACTOR_COMPRESSION_BUILTIN | \
+    ACTOR_COMPRESSION_HAS_LZ4 | ACTOR_COMPRESSION_HAS_ZSTD)
+
+// compression level of zstd
+#define ACTOR_COMPRESSION_ZSTD_LEVEL (1)
+
+// codec type
+typedef int actor_compression_codec_t;
+
+// select fastest codec of bit mask
+actor_compression_codec_t actor_compression_select(int codecs);
+
+// compress data, fails with ACTOR_ERROR, if the result does not fit into
+// capacity bytes
+actor_error_t actor_compression_compress(actor_compression_codec_t codec,
+    const char* source, actor_size_t size, char* destination,
+    actor_size_t capacity, actor_size_t* compressed_size);
+
+// decompress data, which must result in exactly size bytes
+actor_error_t actor_compression_decompress(actor_compression_codec_t codec,
+    const char* source, actor_size_t compressed_size, char* destination,
+    actor_size_t size);
+
+#endif
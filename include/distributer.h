@@ -23,23 +23,140 @@
 // key length
 #define ACTOR_DISTRIBUTER_KEYLENGTH (30)
 
-// message header
+// default and maximum number of messages per send batch
+#define ACTOR_DISTRIBUTER_BATCH_SIZE (64)
+#define ACTOR_DISTRIBUTER_MAX_BATCH_SIZE (512)
+
+// default time in seconds a started batch waits for further messages
+#define ACTOR_DISTRIBUTER_FLUSH_LATENCY (0.0)
+
+// number of messages queued for a remote node, senders block while the
+// queue is full, but at most the queue timeout in seconds
+#define ACTOR_DISTRIBUTER_QUEUE_CAPACITY (4096)
+#define ACTOR_DISTRIBUTER_QUEUE_TIMEOUT (10.0)
+
+// receive buffer size of each connection, larger messages are received
+// directly into their own buffer
+#define ACTOR_DISTRIBUTER_RECEIVE_BUFFER_SIZE (64 * 1024)
+
+// version of handshake and frame format
+#define ACTOR_DISTRIBUTER_VERSION (5)
+
+// size of hello exchanged after key: version, byte order, supported
+// compression codecs, transport flags, node id and host id in network byte
+// order
+#define ACTOR_DISTRIBUTER_HELLO_SIZE (16)
+
+// size of each direction of the shared memory ring used between nodes on
+// the same host, must be a power of two
+#define ACTOR_DISTRIBUTER_SHM_RING_SIZE (1024 * 1024)
+
+// frame flags, stored with the version in the first byte of each frame
+#define ACTOR_DISTRIBUTER_FRAME_CHECKSUM (0x01)
+#define ACTOR_DISTRIBUTER_FRAME_NETWORK_ORDER (0x02)
+#define ACTOR_DISTRIBUTER_FRAME_COMPRESSED (0x04)
+#define ACTOR_DISTRIBUTER_FRAME_ROUTED (0x08)
+
+// maximum size of encoded frame header including routing fields and checksum
+#define ACTOR_DISTRIBUTER_MAX_HEADER_SIZE (41)
+
+// default minimum size of compressed messages, 0 disables compression
+#define ACTOR_DISTRIBUTER_COMPRESSION_THRESHOLD (0)
+
+// size of long and unsigned long elements on the wire, so that hosts with
+// 32 and 64 bit long agree on the layout of their payloads
+#define ACTOR_DISTRIBUTER_LONG_SIZE (8)
+
+// default maximum size of received messages before and after decompression,
+// a larger frame closes the connection before any buffer is allocated
+#define ACTOR_DISTRIBUTER_MAX_MESSAGE_SIZE (64 * 1024 * 1024)
+
+// message header, decoded form of a frame header
 typedef struct {
     actor_process_id_t dest_id;
     actor_size_t message_size;
     actor_data_type_t type;
+    int flags;
+    unsigned int checksum;
+    actor_size_t original_size;
+    actor_node_id_t source_nid;
+    actor_process_id_t source_pid;
+    unsigned int correlation_id;
+    bool reply;
+    actor_message_priority_t priority;
 } actor_distributer_header_s;
 typedef actor_distributer_header_s* actor_distributer_header_t;
 
-// connect to node
+// distributer statistics, bytes are counted on the wire including headers
+typedef struct {
+    unsigned long long bytes_sent;
+    unsigned long long bytes_received;
+    unsigned long long frames_compressed;
+    unsigned long long bytes_saved;
+} actor_distributer_stats_s;
+typedef actor_distributer_stats_s* actor_distributer_stats_t;
+
+// distributer, which serves all connections of a node by one reactor
+// thread, the struct is private to the distributer
+typedef struct actor_distributer_s* actor_distributer_t;
+
+// create distributer
+actor_error_t actor_distributer_create(actor_distributer_t* distributerPointer,
+    actor_node_t node);
+
+// cleanup distributer and close all connections
+actor_error_t actor_distributer_release(actor_distributer_t* distributerPointer);
+
+// connect to node, a host name unix:/path connects to the unix domain socket
+// of path and ignores the port
 actor_error_t actor_distributer_connect_to_node(actor_node_t node, actor_node_id_t* nid,
     const char* host_name, unsigned int port, const char* key);
 
-// listen incomming connections
+// start listener, which accepts any number of peers on port until the
+// node is released, handshakes of peers run concurrently in the reactor
+actor_error_t actor_distributer_start_listener(actor_node_t node,
+    unsigned int port, const char* key);
+
+// wait for next peer connecting to listener of port, the listener is
+// started, if not running
 actor_error_t actor_distributer_listen(actor_node_t node, actor_node_id_t* nid,
     unsigned int port, const char* key);
 
+// start listener on endpoint, which is a port number or unix:/path for a
+// unix domain socket, the socket file is removed when the node is released
+actor_error_t actor_distributer_start_listener_endpoint(actor_node_t node,
+    const char* endpoint, const char* key);
+
+// wait for next peer connecting to listener of endpoint, the listener is
+// started, if not running
+actor_error_t actor_distributer_listen_endpoint(actor_node_t node,
+    actor_node_id_t* nid, const char* endpoint, const char* key);
+
 // disconnect from node
 actor_error_t actor_distributer_disconnect_from_node(actor_node_t node, actor_node_id_t nid);
 
+// configure batching of outgoing messages, a batch is sent once it holds
+// batch size messages, or once no further message arrives within flush
+// latency seconds
+actor_error_t actor_distributer_configure_batching(actor_node_t node,
+    actor_size_t batch_size, actor_time_t flush_latency);
+
+// enable checksums of frames sent to remote nodes
+actor_error_t actor_distributer_configure_checksum(actor_node_t node,
+    bool enabled);
+
+// compress messages to remote nodes of at least threshold bytes with the
+// codec negotiated in the handshake, threshold 0 disables compression
+actor_error_t actor_distributer_configure_compression(actor_node_t node,
+    actor_size_t threshold);
+
+// limit size of messages received from remote nodes, size must not exceed
+// INT_MAX
+actor_error_t actor_distributer_configure_max_message_size(actor_node_t node,
+    actor_size_t size);
+
+// get distributer statistics
+actor_error_t actor_distributer_get_stats(actor_node_t node,
+    actor_distributer_stats_t stats);
+
 #endif
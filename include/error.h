@@ -33,6 +33,8 @@ typedef unsigned int actor_error_t;
 #define ACTOR_ERROR_TOO_MANY_PROCESSES  ((actor_error_t)(6))
 #define ACTOR_ERROR_NETWORK             ((actor_error_t)(7))
 #define ACTOR_ERROR_MESSAGE_PASSING     ((actor_error_t)(8))
+#define ACTOR_ERROR_STALE_PROCESS       ((actor_error_t)(9))
+#define ACTOR_ERROR_MAILBOX_FULL        ((actor_error_t)(10))
 
 // get error string by error
 const char* actor_error_string(actor_error_t error);
@@ -23,23 +23,125 @@
 // message data
 typedef void* actor_message_data_t;
 
-// message struct
+// largest correlation id, which leaves room for the reply flag on the wire
+#define ACTOR_MESSAGE_MAX_CORRELATION_ID (0x7fffffff)
+
+// maximum payload size stored inline with the message
+#define ACTOR_MESSAGE_INLINE_SIZE (64)
+
+// message priority, selects the lane of the message queue
+typedef int actor_message_priority_t;
+
+// message priorities, messages of higher priority are received first,
+// supervision notices are always sent as system messages
+#define ACTOR_MESSAGE_PRIORITY_NORMAL ((actor_message_priority_t)(0))
+#define ACTOR_MESSAGE_PRIORITY_SYSTEM ((actor_message_priority_t)(1))
+
+// number of lanes of a message queue, one per priority
+#define ACTOR_MESSAGE_QUEUE_LANE_COUNT (2)
+
+// message pool
+typedef struct actor_message_pool_s* actor_message_pool_t;
+
+// release function for message data owned by a message
+typedef void (*actor_message_free_function_t)(actor_message_data_t data);
+
+// immutable reference counted payload shared by several messages
+typedef struct {
+    long reference_count;
+    actor_size_t size;
+    long double data[];
+} actor_message_payload_s;
+typedef actor_message_payload_s* actor_message_payload_t;
+
+// message destination
+typedef struct {
+    actor_node_id_t nid;
+    actor_process_id_t pid;
+} actor_message_destination_s;
+typedef actor_message_destination_s* actor_message_destination_t;
+
+// message struct, small payloads are stored inline, messages of a call and
+// their replies share a non zero correlation id
 typedef struct {
     struct actor_message_s* next;
     actor_node_id_t destination_nid;
     actor_process_id_t destination_pid;
+    actor_node_id_t source_nid;
+    actor_process_id_t source_pid;
+    unsigned int correlation_id;
+    bool reply;
+    actor_message_priority_t priority;
     actor_size_t size;
     actor_message_data_t data;
     actor_data_type_t type;
+    actor_message_pool_t pool;
+    actor_size_t capacity;
+    actor_message_free_function_t free_function;
+    actor_message_payload_t shared_payload;
+    long double payload[];
 } actor_message_s;
 typedef actor_message_s* actor_message_t;
 
-// message queue
+// notification of a consumer, which neither blocks nor parks
+typedef void (*actor_message_queue_notify_function_t)(void* context);
+
+// predicate of selective receive, returns true for matching messages
+typedef bool (^actor_message_predicate_t)(actor_message_t message);
+
+// policy of a full bounded queue
+typedef int actor_message_queue_policy_t;
+
+// queue policies
+#define ACTOR_MESSAGE_QUEUE_BLOCK       ((actor_message_queue_policy_t)(0))
+#define ACTOR_MESSAGE_QUEUE_REJECT      ((actor_message_queue_policy_t)(1))
+#define ACTOR_MESSAGE_QUEUE_DROP_OLDEST ((actor_message_queue_policy_t)(2))
+#define ACTOR_MESSAGE_QUEUE_DROP_NEWEST ((actor_message_queue_policy_t)(3))
+
+// lane of message queue, lock-free multi producer single consumer queue
 typedef struct {
-    dispatch_semaphore_t semaphore_read_write;
-    dispatch_semaphore_t semaphore_messages;
     actor_message_t first;
     actor_message_t last;
+    actor_message_t stub;
+} actor_message_queue_lane_s;
+typedef actor_message_queue_lane_s* actor_message_queue_lane_t;
+
+// producer running as green task, which waits for space in a full queue,
+// the waiter lives on the stack of the parked task
+typedef struct actor_message_queue_waiter_s {
+    struct actor_message_queue_waiter_s* next;
+    actor_scheduler_task_t task;
+    bool woken;
+} actor_message_queue_waiter_s;
+typedef actor_message_queue_waiter_s* actor_message_queue_waiter_t;
+
+// message queue, one lane per priority, a non zero capacity bounds the
+// normal messages as given by policy
+typedef struct {
+    actor_message_queue_lane_s lanes[ACTOR_MESSAGE_QUEUE_LANE_COUNT];
+    actor_message_t saved_first[ACTOR_MESSAGE_QUEUE_LANE_COUNT];
+    actor_message_t saved_last[ACTOR_MESSAGE_QUEUE_LANE_COUNT];
+    long waiting;
+    dispatch_semaphore_t semaphore_messages;
+    actor_scheduler_task_t task;
+    actor_message_queue_notify_function_t notify_function;
+    void* notify_context;
+    long count;
+    actor_size_t capacity;
+    actor_message_queue_policy_t policy;
+    actor_time_t block_timeout;
+    long space_waiting;
+    dispatch_semaphore_t semaphore_space;
+    actor_message_queue_waiter_t space_first;
+    actor_message_queue_waiter_t space_last;
+    long space_parked;
+    long space_lock;
+    long pop_lock;
+    long pushing;
+    long closed;
+    actor_message_queue_notify_function_t space_notify_function;
+    void* space_notify_context;
+    unsigned long long dropped;
 } actor_message_queue_s;
 typedef actor_message_queue_s* actor_message_queue_t;
 
@@ -47,21 +149,88 @@ typedef actor_message_queue_s* actor_message_queue_t;
 actor_error_t actor_message_create(actor_message_t* messagePointer,
     actor_data_type_t type, actor_message_data_t const data, actor_size_t size);
 
+// create new message from pool, pool may be NULL
+actor_error_t actor_message_create_pooled(actor_message_pool_t pool,
+    actor_message_t* messagePointer, actor_data_type_t type,
+    actor_message_data_t const data, actor_size_t size);
+
+// create new message taking ownership of data, pool may be NULL
+actor_error_t actor_message_create_owned(actor_message_pool_t pool,
+    actor_message_t* messagePointer, actor_data_type_t type,
+    actor_message_data_t data, actor_size_t size,
+    actor_message_free_function_t free_function);
+
+// create new message referencing shared payload, pool may be NULL
+actor_error_t actor_message_create_shared(actor_message_pool_t pool,
+    actor_message_t* messagePointer, actor_data_type_t type,
+    actor_message_payload_t payload);
+
 // cleanup message
 actor_error_t actor_message_release(actor_message_t* messagePointer);
 
+// create shared payload with copy of data
+actor_error_t actor_message_payload_create(actor_message_payload_t* payloadPointer,
+    actor_message_data_t const data, actor_size_t size);
+
+// retain shared payload
+actor_error_t actor_message_payload_retain(actor_message_payload_t payload);
+
+// release shared payload, memory is freed with last reference
+actor_error_t actor_message_payload_release(actor_message_payload_t* payloadPointer);
+
 // create new queue
 actor_error_t actor_message_queue_create(actor_message_queue_t* queuePointer);
 
-// cleanup queue
+// close queue, messages put later fail with ACTOR_ERROR_STALE_PROCESS
+actor_error_t actor_message_queue_close(actor_message_queue_t queue);
+
+// cleanup queue, waits for blocked and parked producers, others must not
+// use the queue anymore
 actor_error_t actor_message_queue_release(actor_message_queue_t* queuePointer);
 
-// add new message to queue
+// limit queue to capacity messages, must be called before first use,
+// capacity 0 makes the queue unbounded
+actor_error_t actor_message_queue_set_capacity(actor_message_queue_t queue,
+    actor_size_t capacity, actor_message_queue_policy_t policy,
+    actor_time_t timeout);
+
+// add new message to queue, message is only consumed on success, a dropped
+// message counts as success
 actor_error_t actor_message_queue_put(actor_message_queue_t queue,
     actor_message_t message);
 
+// add new message to queue without waiting for space
+actor_error_t actor_message_queue_try_put(actor_message_queue_t queue,
+    actor_message_t message);
+
 // get message from queue
 actor_error_t actor_message_queue_get(actor_message_queue_t queue,
     actor_message_t* message, actor_time_t timeout);
 
+// get up to max messages, waits only for the first one and takes all
+// further available messages without synchronisation
+actor_error_t actor_message_queue_get_batch(actor_message_queue_t queue,
+    actor_message_t* messages, actor_size_t max, actor_size_t* count,
+    actor_time_t timeout);
+
+// get first message matching predicate, other messages keep their order
+actor_error_t actor_message_queue_get_match(actor_message_queue_t queue,
+    actor_message_t* message, actor_message_predicate_t predicate,
+    actor_time_t timeout);
+
+// get first message matching predicate, which arrived after the messages
+// in the save list, e.g. the reply to a request sent after them
+actor_error_t actor_message_queue_get_new_match(actor_message_queue_t queue,
+    actor_message_t* message, actor_message_predicate_t predicate,
+    actor_time_t timeout);
+
+// call function with context once, when the full queue gets space or is
+// closed, e.g. to retry a try put, which failed with ACTOR_ERROR_MAILBOX_FULL
+actor_error_t actor_message_queue_notify_space(actor_message_queue_t queue,
+    actor_message_queue_notify_function_t function, void* context);
+
+// arm empty queue to notify consumer about next message, armed is false,
+// if queue is not empty and consumer has to continue
+actor_error_t actor_message_queue_arm(actor_message_queue_t queue, bool* armed);
+
 #endif
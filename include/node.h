@@ -23,25 +23,78 @@
 // maximum remote nodes count
 #define ACTOR_NODE_MAX_REMOTE_NODES (1024)
 
-// node struct
+// process ids hold the index of the message queue slot in the lower bits
+// and the generation of the slot in the upper bits
+#define ACTOR_NODE_PID_INDEX_BITS (20)
+#define ACTOR_NODE_PID_GENERATION_BITS (11)
+
+// the process table consists of segments, the first one holds 64 slots and
+// each further segment twice as much as the previous one
+#define ACTOR_NODE_SEGMENT_MIN_BITS (6)
+#define ACTOR_NODE_SEGMENT_MIN_SIZE (1 << ACTOR_NODE_SEGMENT_MIN_BITS)
+#define ACTOR_NODE_SEGMENT_COUNT (14)
+
+// maximum process count, fits into the pid index bits
+#define ACTOR_NODE_MAX_PROCESSES (ACTOR_NODE_SEGMENT_MIN_SIZE * \
+    ((1 << ACTOR_NODE_SEGMENT_COUNT) - 1))
+
+// producer count of a released slot without producers, the slot is freed
+// by the releaser or by its last producer
+#define ACTOR_NODE_SLOT_RELEASED (1l << 30)
+
+// message queue slot, the generation is incremented on every release to
+// detect stale process ids, producers counts messages being put into the
+// queue, which is freed only after they left
+typedef struct {
+    actor_message_queue_t queue;
+    long generation;
+    long producers;
+    long next_free;
+} actor_node_slot_s;
+typedef actor_node_slot_s* actor_node_slot_t;
+
+// node struct, free slots are reused in FIFO order, the process table grows
+// by one segment, once no slot is free, segments are never moved
 typedef struct {
     actor_node_id_t id;
-    actor_message_queue_t* message_queues;
+    actor_message_pool_t message_pool;
+    actor_scheduler_t scheduler;
+    actor_timer_wheel_t timer_wheel;
+    actor_node_slot_t message_queues[ACTOR_NODE_SEGMENT_COUNT];
+    actor_size_t segment_count;
+    struct actor_distributer_s* distributer;
+    long distributer_notifying;
     actor_process_id_t* remote_nodes;
+    actor_size_t distributer_batch_size;
+    actor_time_t distributer_flush_latency;
+    bool distributer_checksum;
+    actor_size_t distributer_compression_threshold;
+    actor_size_t distributer_max_message_size;
+    unsigned int correlation_counter;
     actor_size_t message_queue_count;
-    actor_size_t message_queue_pos;
+    long free_first;
+    long free_last;
+    dispatch_semaphore_t free_semaphore;
+    dispatch_semaphore_t grow_semaphore;
     dispatch_semaphore_t process_semaphore;
-    dispatch_semaphore_t message_queue_create_semaphore;
-    actor_size_t process_count;
+    long process_count;
 } actor_node_s;
 typedef actor_node_s* actor_node_t;
 
+// handle of delayed or periodic message, the struct is private to the node
+typedef struct actor_node_timer_s* actor_node_timer_t;
+
 #include "process.h"
 
-// create node
+// create node, the process table holds size processes initially and grows
+// on demand
 actor_error_t actor_node_create(actor_node_t* nodePointer, actor_node_id_t id,
     actor_size_t size);
 
+// create node with given scheduler
+actor_error_t actor_node_create_with_scheduler(actor_node_t* nodePointer,
+    actor_node_id_t id, actor_size_t size, actor_scheduler_type_t scheduler);
+
 // cleanup
 actor_error_t actor_node_release(actor_node_t* nodePointer);
 
@@ -49,35 +102,149 @@ actor_error_t actor_node_release(actor_node_t* nodePointer);
 actor_error_t actor_node_spawn_process(actor_node_t node, actor_process_id_t* pid,
     actor_process_function_t function);
 
+// spawn new process, whose mailbox holds at most capacity messages, a full
+// mailbox blocks senders, rejects or drops messages as given by policy
+actor_error_t actor_node_spawn_bounded_process(actor_node_t node,
+    actor_process_id_t* pid, actor_size_t capacity,
+    actor_message_queue_policy_t policy, actor_time_t timeout,
+    actor_process_function_t function);
+
+// spawn new reactive process, which only runs to handle messages
+actor_error_t actor_node_spawn_reactive_process(actor_node_t node,
+    actor_process_id_t* pid, actor_process_handler_t handler);
+
+// spawn new process, which always gets its own thread, because it blocks
+// outside of receive and sleep
+actor_error_t actor_node_spawn_blocking_process(actor_node_t node,
+    actor_process_id_t* pid, actor_process_function_t function);
+
 // message sending
 actor_error_t actor_node_send_message(actor_node_t node,
     actor_node_id_t destination_nid, actor_process_id_t destination_pid,
     actor_data_type_t type, actor_message_data_t const data, actor_size_t size);
 
+// message sending on behalf of local source process, a non zero correlation
+// id marks a request of a call or, with reply set, its reply
+actor_error_t actor_node_send_message_from(actor_node_t node,
+    actor_process_id_t source_pid, actor_node_id_t destination_nid,
+    actor_process_id_t destination_pid, actor_data_type_t type,
+    actor_message_data_t const data, actor_size_t size,
+    unsigned int correlation_id, bool reply);
+
+// message sending with system priority, which overtakes queued normal
+// messages and ignores the capacity of bounded mailboxes, source pid may be
+// ACTOR_INVALID_ID
+actor_error_t actor_node_send_system_message(actor_node_t node,
+    actor_process_id_t source_pid, actor_node_id_t destination_nid,
+    actor_process_id_t destination_pid, actor_data_type_t type,
+    actor_message_data_t const data, actor_size_t size);
+
+// message sending after delay, the message is delivered by the timer wheel
+// without waiting for space in a full mailbox, a non NULL timer is set to a
+// handle, which must be released by actor_node_cancel_timer before the node
+actor_error_t actor_node_send_message_after(actor_node_t node,
+    actor_process_id_t source_pid, actor_time_t delay,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size,
+    actor_node_timer_t* timer);
+
+// periodic message sending, the first message is sent after one period,
+// all messages share one copy of data
+actor_error_t actor_node_send_message_interval(actor_node_t node,
+    actor_process_id_t source_pid, actor_time_t period,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size,
+    actor_node_timer_t* timer);
+
+// cancel delayed or periodic message and release its handle,
+// ACTOR_ERROR_TIMEOUT tells, that the delayed message was already sent
+actor_error_t actor_node_cancel_timer(actor_node_t node,
+    actor_node_timer_t* timerPointer);
+
+// get new correlation id for a call
+actor_error_t actor_node_get_correlation_id(actor_node_t node,
+    unsigned int* correlation_id);
+
+// message sending without copy, on success data is owned by the message
+actor_error_t actor_node_send_message_owned(actor_node_t node,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t data, actor_size_t size,
+    actor_message_free_function_t free_function);
+
+// send one shared copy of data to several destinations
+actor_error_t actor_node_broadcast_message(actor_node_t node,
+    actor_message_destination_s const* destinations, actor_size_t count,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size);
+
+// deliver message, message is only consumed on success
+actor_error_t actor_node_deliver_message(actor_node_t node,
+    actor_message_t message);
+
+// deliver message without waiting for space in a full mailbox
+actor_error_t actor_node_try_deliver_message(actor_node_t node,
+    actor_message_t message);
+
+// deliver message without waiting, function is called with context once a
+// full mailbox has space again
+actor_error_t actor_node_try_deliver_message_notify(actor_node_t node,
+    actor_message_t message, actor_message_queue_notify_function_t function,
+    void* context);
+
 // get free message queue
 actor_error_t actor_node_get_free_message_queue(actor_node_t node,
     actor_message_queue_t* queue, actor_process_id_t* id);
 
-// get message queue for id
+// get message queue for id, the queue is not protected against a
+// concurrent release
 actor_error_t actor_node_get_message_queue(actor_node_t node,
     actor_message_queue_t** queue, actor_process_id_t id);
 
-// release message queue
+// release message queue, producers still putting messages get
+// ACTOR_ERROR_STALE_PROCESS and the last of them frees the queue
 actor_error_t actor_node_message_queue_release(actor_node_t node,
     actor_process_id_t pid);
 
 // wait for processes to complete
 actor_error_t actor_node_wait_for_processes(actor_node_t node, actor_time_t timeout);
 
-// connect to remote node
+// connect to remote node, host name unix:/path connects to a unix domain
+// socket
 actor_error_t actor_node_connect(actor_node_t node, actor_node_id_t* nid,
     const char* host_name, unsigned int host_port, const char* key);
 
-// listen for incomming connection
+// accept any number of incomming connections on port
+actor_error_t actor_node_start_listener(actor_node_t node, unsigned int port,
+    const char* key);
+
+// wait for next incomming connection on port
 actor_error_t actor_node_listen(actor_node_t node, actor_node_id_t* nid,
     unsigned int port, const char* key);
 
+// accept any number of incomming connections on endpoint, which is a port
+// number or unix:/path
+actor_error_t actor_node_start_listener_endpoint(actor_node_t node,
+    const char* endpoint, const char* key);
+
+// wait for next incomming connection on endpoint
+actor_error_t actor_node_listen_endpoint(actor_node_t node, actor_node_id_t* nid,
+    const char* endpoint, const char* key);
+
 // close connection
 actor_error_t actor_node_disconnect(actor_node_t node, actor_node_id_t nid);
 
+// configure batching of messages to remote nodes
+actor_error_t actor_node_configure_batching(actor_node_t node,
+    actor_size_t batch_size, actor_time_t flush_latency);
+
+// enable checksums of messages to remote nodes
+actor_error_t actor_node_configure_checksum(actor_node_t node, bool enabled);
+
+// compress messages to remote nodes of at least threshold bytes
+actor_error_t actor_node_configure_compression(actor_node_t node,
+    actor_size_t threshold);
+
+// limit size of messages received from remote nodes
+actor_error_t actor_node_configure_max_message_size(actor_node_t node,
+    actor_size_t size);
+
 #endif
@@ -0,0 +1,92 @@
+// libactor
+//
+// Implementation of an erlang style actor model using libdispatch
+// Copyright (C) 2012  Patrik Gebhardt
+// Contact: patrik.gebhardt@rub.de
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ACTOR_POOL_H
+#define ACTOR_POOL_H
+
+// number of payload size classes
+#define ACTOR_MESSAGE_POOL_CLASS_COUNT (4)
+
+// payload capacity of smallest class, each further class is 4 times larger
+#define ACTOR_MESSAGE_POOL_MIN_SIZE (ACTOR_MESSAGE_INLINE_SIZE)
+
+// payload capacity of largest class
+#define ACTOR_MESSAGE_POOL_MAX_SIZE (ACTOR_MESSAGE_POOL_MIN_SIZE << \
+    (2 * (ACTOR_MESSAGE_POOL_CLASS_COUNT - 1)))
+
+// maximum number of cached messages per class and thread
+#define ACTOR_MESSAGE_POOL_CACHE_SIZE (64)
+
+// maximum number of messages per class in shared depot
+#define ACTOR_MESSAGE_POOL_DEPOT_SIZE (1024)
+
+// pool statistics
+typedef struct {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long bytes_held;
+} actor_message_pool_stats_s;
+typedef actor_message_pool_stats_s* actor_message_pool_stats_t;
+
+// per thread message cache
+typedef struct actor_message_pool_cache_s {
+    struct actor_message_pool_cache_s* next;
+    struct actor_message_pool_cache_s* thread_next;
+    struct actor_message_pool_s* pool;
+    actor_message_t messages[ACTOR_MESSAGE_POOL_CLASS_COUNT];
+    actor_size_t counts[ACTOR_MESSAGE_POOL_CLASS_COUNT];
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long puts;
+} actor_message_pool_cache_s;
+typedef actor_message_pool_cache_s* actor_message_pool_cache_t;
+
+// message pool, thread caches exchange batches of messages with the depot
+struct actor_message_pool_s {
+    pthread_key_t cache_key;
+    dispatch_semaphore_t depot_semaphore;
+    actor_message_t depot[ACTOR_MESSAGE_POOL_CLASS_COUNT];
+    actor_size_t depot_counts[ACTOR_MESSAGE_POOL_CLASS_COUNT];
+    actor_message_pool_cache_t caches;
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long puts;
+    long long live;
+    bool released;
+};
+typedef struct actor_message_pool_s actor_message_pool_s;
+
+// create pool
+actor_error_t actor_message_pool_create(actor_message_pool_t* poolPointer);
+
+// cleanup pool, messages still alive are freed on return
+actor_error_t actor_message_pool_release(actor_message_pool_t* poolPointer);
+
+// get message with payload capacity for size bytes from pool
+actor_error_t actor_message_pool_get(actor_message_pool_t pool,
+    actor_message_t* messagePointer, actor_size_t size);
+
+// return message to its pool
+actor_error_t actor_message_pool_put(actor_message_t message);
+
+// get pool statistics
+actor_error_t actor_message_pool_get_stats(actor_message_pool_t pool,
+    actor_message_pool_stats_t stats);
+
+#endif
@@ -29,6 +29,10 @@ typedef struct {
     actor_process_id_t supervisor_pid;
     actor_message_queue_t message_queue;
     dispatch_semaphore_t sleep_semaphore;
+    actor_scheduler_task_t task;
+    void* function;
+    bool reactive;
+    bool stopped;
 } actor_process_s;
 typedef actor_process_s* actor_process_t;
 
@@ -43,6 +47,14 @@ typedef actor_process_error_message_s* actor_process_error_message_t;
 // Process block signature
 typedef actor_error_t (^actor_process_function_t)(actor_process_t self);
 
+// Reactive process handler signature, the handler is called for each
+// message and the message is released after the handler returns
+typedef actor_error_t (^actor_process_handler_t)(actor_process_t self,
+    actor_message_t message);
+
+// number of messages handled by a reactive process in one run
+#define ACTOR_PROCESS_REACTIVE_BATCH_SIZE (64)
+
 // create process
 actor_error_t actor_process_create(actor_node_t node, actor_process_t* processPointer);
 
@@ -53,9 +65,28 @@ actor_error_t actor_process_release(actor_process_t* processPointer);
 actor_error_t actor_process_receive_message(actor_process_t process, actor_message_t* message,
     actor_time_t timeout);
 
+// receive up to max messages, count is set to the number of received
+// messages
+actor_error_t actor_process_receive_messages(actor_process_t process,
+    actor_message_t* messages, actor_size_t max, actor_size_t* count,
+    actor_time_t timeout);
+
+// selective message receive
+actor_error_t actor_process_receive_matching_message(actor_process_t process,
+    actor_message_t* message, actor_message_predicate_t predicate,
+    actor_time_t timeout);
+
+// receive reply of call with correlation id, only messages arrived after
+// the request are checked
+actor_error_t actor_process_receive_reply(actor_process_t process,
+    actor_message_t* message, unsigned int correlation_id, actor_time_t timeout);
+
 // sleep
 actor_error_t actor_process_sleep(actor_process_t process, actor_time_t time);
 
+// stop reactive process after current handler call
+actor_error_t actor_process_stop(actor_process_t process);
+
 // link
 actor_error_t actor_process_link(actor_process_t process,
     actor_node_id_t supervisor_nid, actor_process_id_t supervisor_pid);
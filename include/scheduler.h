@@ -0,0 +1,113 @@
+// libactor
+//
+// Implementation of an erlang style actor model using libdispatch
+// Copyright (C) 2012  Patrik Gebhardt
+// Contact: patrik.gebhardt@rub.de
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ACTOR_SCHEDULER_H
+#define ACTOR_SCHEDULER_H
+
+// scheduler type
+typedef int actor_scheduler_type_t;
+
+// scheduler types
+#define ACTOR_SCHEDULER_DISPATCH    ((actor_scheduler_type_t)(0))
+#define ACTOR_SCHEDULER_GREEN       ((actor_scheduler_type_t)(1))
+
+// stack size of green processes
+#define ACTOR_SCHEDULER_STACK_SIZE (256 * 1024)
+
+// park without timeout
+#define ACTOR_SCHEDULER_FOREVER ((actor_time_t)(-1.0))
+
+// capacity of the run queue of each worker, must be a power of two
+#define ACTOR_SCHEDULER_DEQUE_SIZE (4096)
+
+// task function
+typedef void (*actor_scheduler_function_t)(void* context);
+
+// green task, the struct holds the machine context and is private to the
+// scheduler
+typedef struct actor_scheduler_task_s* actor_scheduler_task_t;
+
+// run queue of a worker, the owning worker pushes and pops tasks at the
+// bottom, idle workers steal tasks from the top
+typedef struct {
+    struct actor_scheduler_s* scheduler;
+    actor_scheduler_task_t* tasks;
+    long top;
+    long bottom;
+    char padding[64];
+} actor_scheduler_deque_s;
+typedef actor_scheduler_deque_s* actor_scheduler_deque_t;
+
+// scheduler struct, workers run green tasks from their own run queue and
+// steal from each other
+typedef struct actor_scheduler_s {
+    pthread_t* workers;
+    actor_size_t worker_count;
+    actor_scheduler_deque_t deques;
+    actor_size_t deque_count;
+    pthread_mutex_t lock;
+    pthread_cond_t condition;
+    actor_scheduler_task_t inject_first;
+    actor_scheduler_task_t inject_last;
+    long inject_count;
+    long idle_count;
+    actor_scheduler_task_t tasks;
+    actor_timer_wheel_t timer_wheel;
+    bool running;
+} actor_scheduler_s;
+typedef actor_scheduler_s* actor_scheduler_t;
+
+// create scheduler, worker count 0 uses one worker per core, the timer
+// wheel must outlive the scheduler
+actor_error_t actor_scheduler_create(actor_scheduler_t* schedulerPointer,
+    actor_size_t worker_count, actor_timer_wheel_t timer_wheel);
+
+// cleanup scheduler
+actor_error_t actor_scheduler_release(actor_scheduler_t* schedulerPointer);
+
+// create task, which is not started yet, release function may be NULL and
+// gets the context of a task, which did not finish before scheduler release
+actor_error_t actor_scheduler_task_create(actor_scheduler_t scheduler,
+    actor_scheduler_task_t* taskPointer, actor_scheduler_function_t function,
+    actor_scheduler_function_t release_function, void* context);
+
+// create job, which runs on the stack of a worker each time it is started
+actor_error_t actor_scheduler_job_create(actor_scheduler_t scheduler,
+    actor_scheduler_task_t* jobPointer, actor_scheduler_function_t function,
+    actor_scheduler_function_t release_function, void* context);
+
+// cleanup job, may be called by the job function itself
+actor_error_t actor_scheduler_job_release(actor_scheduler_task_t* jobPointer);
+
+// start task or job
+actor_error_t actor_scheduler_task_start(actor_scheduler_task_t task);
+
+// park calling task until it is unparked or timeout expires
+actor_error_t actor_scheduler_task_park(actor_scheduler_task_t task,
+    actor_time_t timeout);
+
+// unpark task
+actor_error_t actor_scheduler_task_unpark(actor_scheduler_task_t task);
+
+// get green task running on calling thread, worker tells, that the thread
+// is a worker of a scheduler, so a NULL task means a job, which cannot park
+actor_error_t actor_scheduler_current_task(actor_scheduler_task_t* taskPointer,
+    bool* worker);
+
+#endif
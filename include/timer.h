@@ -0,0 +1,96 @@
+// libactor
+//
+// Implementation of an erlang style actor model using libdispatch
+// Copyright (C) 2012  Patrik Gebhardt
+// Contact: patrik.gebhardt@rub.de
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ACTOR_TIMER_H
+#define ACTOR_TIMER_H
+
+// length of one tick of the timer wheel in nanoseconds
+#define ACTOR_TIMER_TICK (1000000ull)
+
+// each level of the timer wheel has 64 slots, a slot of a level spans all
+// slots of the level below, so 5 levels cover about 12 days
+#define ACTOR_TIMER_LEVEL_BITS (6)
+#define ACTOR_TIMER_LEVEL_SIZE (1 << ACTOR_TIMER_LEVEL_BITS)
+#define ACTOR_TIMER_LEVEL_COUNT (5)
+
+// timer function, called by the thread of the wheel, so it must not block
+typedef void (*actor_timer_function_t)(void* context);
+
+// timer struct, which is embedded into or allocated by its owner
+typedef struct actor_timer_s {
+    struct actor_timer_s* next;
+    struct actor_timer_s** link;
+    unsigned long long expires;
+    unsigned long long period;
+    int level;
+    int slot;
+    actor_timer_function_t function;
+    actor_timer_function_t drop_function;
+    void* context;
+} actor_timer_s;
+typedef actor_timer_s* actor_timer_t;
+
+// timer wheel struct, timers are moved down the levels until they expire
+typedef struct {
+    actor_timer_t slots[ACTOR_TIMER_LEVEL_COUNT][ACTOR_TIMER_LEVEL_SIZE];
+    unsigned long long occupied[ACTOR_TIMER_LEVEL_COUNT];
+    unsigned long long current;
+    unsigned long long wakeup;
+    actor_timer_t expired;
+    actor_timer_t firing;
+    actor_size_t count;
+    long firing_waiting;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t condition;
+    pthread_cond_t firing_condition;
+    bool started;
+    bool running;
+} actor_timer_wheel_s;
+typedef actor_timer_wheel_s* actor_timer_wheel_t;
+
+// create timer wheel
+actor_error_t actor_timer_wheel_create(actor_timer_wheel_t* wheelPointer);
+
+// stop expiring timers, timers can still be added and removed
+actor_error_t actor_timer_wheel_stop(actor_timer_wheel_t wheel);
+
+// cleanup timer wheel, the drop function of each pending timer is called
+actor_error_t actor_timer_wheel_release(actor_timer_wheel_t* wheelPointer);
+
+// init timer, drop function may be NULL
+actor_error_t actor_timer_init(actor_timer_t timer,
+    actor_timer_function_t function, actor_timer_function_t drop_function,
+    void* context);
+
+// add timer, which expires after delay, a pending timer is moved
+actor_error_t actor_timer_wheel_add(actor_timer_wheel_t wheel,
+    actor_timer_t timer, actor_time_t delay);
+
+// add timer, which expires after delay and then once every period, until
+// it is removed
+actor_error_t actor_timer_wheel_add_periodic(actor_timer_wheel_t wheel,
+    actor_timer_t timer, actor_time_t delay, actor_time_t period);
+
+// remove pending timer, ACTOR_ERROR_TIMEOUT tells, that it already
+// expired or was never added, a running timer function is waited for
+actor_error_t actor_timer_wheel_remove(actor_timer_wheel_t wheel,
+    actor_timer_t timer);
+
+#endif
@@ -41,4 +41,9 @@ typedef int actor_data_type_t;
 #define ACTOR_TYPE_KEY              ((actor_data_type_t)(14))
 #define ACTOR_TYPE_CUSTOM           ((actor_data_type_t)(15))
 
+// file descriptor as int payload, the descriptor is passed to the receiving
+// process, which has to close it, nodes connected by a unix domain socket
+// pass it as a duplicate, all other connections drop it
+#define ACTOR_TYPE_FILE_DESCRIPTOR  ((actor_data_type_t)(16))
+
 #endif
@@ -26,13 +26,84 @@ actor_error_t actor_spawn(actor_node_t node, actor_process_id_t* pid,
     return actor_node_spawn_process(node, pid, function);
 }
 
+// spawn process with bounded mailbox
+actor_error_t actor_spawn_bounded(actor_node_t node, actor_process_id_t* pid,
+    actor_size_t capacity, actor_message_queue_policy_t policy,
+    actor_time_t timeout, actor_process_function_t function) {
+    // call method
+    return actor_node_spawn_bounded_process(node, pid, capacity, policy,
+        timeout, function);
+}
+
+// spawn reactive process
+actor_error_t actor_spawn_reactive(actor_node_t node, actor_process_id_t* pid,
+    actor_process_handler_t handler) {
+    // call method
+    return actor_node_spawn_reactive_process(node, pid, handler);
+}
+
 // message sendig
 actor_error_t actor_send(actor_process_t process,
     actor_node_id_t destination_nid, actor_process_id_t destination_pid,
     actor_data_type_t type, actor_message_data_t const data, actor_size_t size) {
     // call method
-    return actor_node_send_message(process->node, destination_nid, destination_pid,
-    type, data, size);
+    return actor_node_send_message_from(process->node, process->pid,
+        destination_nid, destination_pid, type, data, size, 0, false);
+}
+
+// message sending with system priority
+actor_error_t actor_send_system(actor_process_t process,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size) {
+    // call method
+    return actor_node_send_system_message(process->node, process->pid,
+        destination_nid, destination_pid, type, data, size);
+}
+
+// message sending after delay
+actor_error_t actor_send_after(actor_process_t process, actor_time_t delay,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size,
+    actor_node_timer_t* timer) {
+    // call method
+    return actor_node_send_message_after(process->node, process->pid, delay,
+        destination_nid, destination_pid, type, data, size, timer);
+}
+
+// periodic message sending
+actor_error_t actor_send_interval(actor_process_t process, actor_time_t period,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size,
+    actor_node_timer_t* timer) {
+    // call method
+    return actor_node_send_message_interval(process->node, process->pid,
+        period, destination_nid, destination_pid, type, data, size, timer);
+}
+
+// cancel delayed or periodic message
+actor_error_t actor_cancel_timer(actor_process_t process,
+    actor_node_timer_t* timer) {
+    // call method
+    return actor_node_cancel_timer(process->node, timer);
+}
+
+// message sending without copy
+actor_error_t actor_send_owned(actor_process_t process,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t data, actor_size_t size,
+    actor_message_free_function_t free_function) {
+    // call method
+    return actor_node_send_message_owned(process->node, destination_nid,
+        destination_pid, type, data, size, free_function);
+}
+
+// message broadcast
+actor_error_t actor_broadcast(actor_process_t process,
+    actor_message_destination_s const* destinations, actor_size_t count,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size) {
+    // call method
+    return actor_node_broadcast_message(process->node, destinations, count,
+        type, data, size);
 }
 
 // message receive
@@ -41,3 +112,85 @@ actor_error_t actor_receive(actor_process_t process, actor_message_t* message,
     // call method
     return actor_process_receive_message(process, message, timeout);
 }
+
+// receive up to max messages
+actor_error_t actor_receive_batch(actor_process_t process,
+    actor_message_t* messages, actor_size_t max, actor_size_t* count,
+    actor_time_t timeout) {
+    // call method
+    return actor_process_receive_messages(process, messages, max, count,
+        timeout);
+}
+
+// selective message receive
+actor_error_t actor_receive_match(actor_process_t process,
+    actor_message_t* message, actor_message_predicate_t predicate,
+    actor_time_t timeout) {
+    // call method
+    return actor_process_receive_matching_message(process, message, predicate,
+        timeout);
+}
+
+// receive first message of type
+actor_error_t actor_receive_type(actor_process_t process,
+    actor_message_t* message, actor_data_type_t type, actor_time_t timeout) {
+    // match type
+    return actor_process_receive_matching_message(process, message,
+        ^bool(actor_message_t candidate) {
+            return candidate->type == type;
+        }, timeout);
+}
+
+// send request and wait for its reply
+actor_error_t actor_call(actor_process_t process,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size,
+    actor_message_t* reply, actor_time_t timeout) {
+    // check input, reactive processes cannot wait for the reply
+    if ((process == NULL) || (reply == NULL) || (timeout < 0.0) ||
+        process->reactive) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // init reply pointer to NULL
+    *reply = NULL;
+
+    // get correlation id
+    unsigned int correlation_id = 0;
+    actor_error_t error = actor_node_get_correlation_id(process->node,
+        &correlation_id);
+
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        return error;
+    }
+
+    // send request
+    error = actor_node_send_message_from(process->node, process->pid,
+        destination_nid, destination_pid, type, data, size, correlation_id,
+        false);
+
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        return error;
+    }
+
+    // wait for reply
+    return actor_process_receive_reply(process, reply, correlation_id, timeout);
+}
+
+// reply to request of call
+actor_error_t actor_reply(actor_process_t process, actor_message_t request,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size) {
+    // check input
+    if ((process == NULL) || (request == NULL) ||
+        (request->correlation_id == 0) || request->reply ||
+        (request->source_pid == ACTOR_INVALID_ID)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // send reply to caller
+    return actor_node_send_message_from(process->node, process->pid,
+        request->source_nid, request->source_pid, type, data, size,
+        request->correlation_id, true);
+}
@@ -0,0 +1,345 @@
+// libactor
+//
+// Implementation of an erlang style actor model using libdispatch
+// Copyright (C) 2012  Patrik Gebhardt
+// Contact: patrik.gebhardt@rub.de
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <limits.h>
+#include "../include/actor.h"
+
+#ifdef ACTOR_USE_LZ4
+#include <lz4.h>
+#endif
+#ifdef ACTOR_USE_ZSTD
+#include <zstd.h>
+#endif
+
+// builtin codec
+//
+// A block is a series of sequences, each made of a token byte holding the
+// literal count and the match length minus 4 in its nibbles, the literals,
+// and a match as 16 bit offset into the decompressed data. Counts of 15 and
+// more continue in following bytes. The last sequence holds literals only.
+#define ACTOR_COMPRESSION_HASH_BITS (12)
+#define ACTOR_COMPRESSION_MIN_MATCH (4)
+#define ACTOR_COMPRESSION_MAX_OFFSET (65535)
+
+// number of bytes at end of block, which are always literals
+#define ACTOR_COMPRESSION_END_LITERALS (5)
+
+// read 4 bytes
+static unsigned int actor_compression_read32(const char* data) {
+    unsigned int value;
+    memcpy(&value, data, sizeof(unsigned int));
+
+    return value;
+}
+
+// hash of 4 bytes
+static unsigned int actor_compression_hash(unsigned int value) {
+    return (value * 2654435761u) >> (32 - ACTOR_COMPRESSION_HASH_BITS);
+}
+
+// write continued count
+static bool actor_compression_put_count(char* destination, actor_size_t* position,
+    actor_size_t capacity, actor_size_t count) {
+    while (count >= 255) {
+        if (*position >= capacity) {
+            return false;
+        }
+
+        destination[(*position)++] = (char)255;
+        count -= 255;
+    }
+
+    if (*position >= capacity) {
+        return false;
+    }
+
+    destination[(*position)++] = (char)count;
+
+    return true;
+}
+
+// read continued count
+static bool actor_compression_get_count(const unsigned char* source,
+    actor_size_t* position, actor_size_t size, unsigned long long* count) {
+    unsigned char byte = 255;
+
+    while (byte == 255) {
+        if (*position >= size) {
+            return false;
+        }
+
+        byte = source[(*position)++];
+        *count += byte;
+    }
+
+    return true;
+}
+
+// write sequence, match length 0 marks the last sequence
+static bool actor_compression_put_sequence(char* destination,
+    actor_size_t* position, actor_size_t capacity, const char* literals,
+    actor_size_t literal_count, actor_size_t offset, actor_size_t match_length) {
+    // reserve token
+    if (*position >= capacity) {
+        return false;
+    }
+    actor_size_t token = (*position)++;
+
+    // write literals
+    actor_size_t literal_nibble = literal_count < 15 ? literal_count : 15;
+    if ((literal_nibble == 15) && !actor_compression_put_count(destination,
+        position, capacity, literal_count - 15)) {
+        return false;
+    }
+
+    if (capacity - *position < literal_count) {
+        return false;
+    }
+    memcpy(&destination[*position], literals, literal_count);
+    *position += literal_count;
+
+    // write match
+    actor_size_t match_nibble = 0;
+    if (match_length != 0) {
+        if (capacity - *position < 2) {
+            return false;
+        }
+        destination[(*position)++] = (char)(offset & 0xff);
+        destination[(*position)++] = (char)(offset >> 8);
+
+        match_length -= ACTOR_COMPRESSION_MIN_MATCH;
+        match_nibble = match_length < 15 ? match_length : 15;
+        if ((match_nibble == 15) && !actor_compression_put_count(destination,
+            position, capacity, match_length - 15)) {
+            return false;
+        }
+    }
+
+    destination[token] = (char)((literal_nibble << 4) | match_nibble);
+
+    return true;
+}
+
+// compress with builtin codec
+static actor_error_t actor_compression_builtin_compress(const char* source,
+    actor_size_t size, char* destination, actor_size_t capacity,
+    actor_size_t* compressed_size) {
+    // positions of last occurrence of hashed bytes plus one
+    unsigned int table[1 << ACTOR_COMPRESSION_HASH_BITS];
+    memset(table, 0, sizeof(table));
+
+    actor_size_t position = 0;
+    actor_size_t anchor = 0;
+    actor_size_t index = 0;
+
+    while ((size > ACTOR_COMPRESSION_END_LITERALS + ACTOR_COMPRESSION_MIN_MATCH) &&
+        (index < size - ACTOR_COMPRESSION_END_LITERALS - ACTOR_COMPRESSION_MIN_MATCH)) {
+        // look up previous occurrence
+        unsigned int value = actor_compression_read32(&source[index]);
+        unsigned int hash = actor_compression_hash(value);
+        actor_size_t reference = table[hash];
+        table[hash] = index + 1;
+
+        if ((reference == 0) || (index - (reference - 1) > ACTOR_COMPRESSION_MAX_OFFSET) ||
+            (actor_compression_read32(&source[reference - 1]) != value)) {
+            index++;
+
+            continue;
+        }
+        reference--;
+
+        // extend match
+        actor_size_t match_length = ACTOR_COMPRESSION_MIN_MATCH;
+        while ((index + match_length < size - ACTOR_COMPRESSION_END_LITERALS) &&
+            (source[reference + match_length] == source[index + match_length])) {
+            match_length++;
+        }
+
+        if (!actor_compression_put_sequence(destination, &position, capacity,
+            &source[anchor], index - anchor, index - reference, match_length)) {
+            return ACTOR_ERROR;
+        }
+
+        index += match_length;
+        anchor = index;
+    }
+
+    // write remaining literals
+    if (!actor_compression_put_sequence(destination, &position, capacity,
+        &source[anchor], size - anchor, 0, 0)) {
+        return ACTOR_ERROR;
+    }
+
+    *compressed_size = position;
+
+    return ACTOR_SUCCESS;
+}
+
+// decompress with builtin codec
+static actor_error_t actor_compression_builtin_decompress(const char* source,
+    actor_size_t compressed_size, char* destination, actor_size_t size) {
+    const unsigned char* input = (const unsigned char*)source;
+    actor_size_t position = 0;
+    actor_size_t output = 0;
+
+    while (position < compressed_size) {
+        unsigned char token = input[position++];
+
+        // copy literals
+        unsigned long long literal_count = token >> 4;
+        if ((literal_count == 15) && !actor_compression_get_count(input,
+            &position, compressed_size, &literal_count)) {
+            return ACTOR_ERROR_INVALUE;
+        }
+
+        if ((literal_count > compressed_size - position) ||
+            (literal_count > size - output)) {
+            return ACTOR_ERROR_INVALUE;
+        }
+        memcpy(&destination[output], &input[position], literal_count);
+        position += literal_count;
+        output += literal_count;
+
+        // last sequence
+        if (position == compressed_size) {
+            break;
+        }
+
+        // copy match, which may overlap its own output
+        if (compressed_size - position < 2) {
+            return ACTOR_ERROR_INVALUE;
+        }
+        actor_size_t offset = input[position] | (input[position + 1] << 8);
+        position += 2;
+
+        unsigned long long match_length = token & 0x0f;
+        if ((match_length == 15) && !actor_compression_get_count(input,
+            &position, compressed_size, &match_length)) {
+            return ACTOR_ERROR_INVALUE;
+        }
+        match_length += ACTOR_COMPRESSION_MIN_MATCH;
+
+        if ((offset == 0) || (offset > output) || (match_length > size - output)) {
+            return ACTOR_ERROR_INVALUE;
+        }
+        for (unsigned long long i = 0; i < match_length; i++) {
+            destination[output] = destination[output - offset];
+            output++;
+        }
+    }
+
+    return output == size ? ACTOR_SUCCESS : ACTOR_ERROR_INVALUE;
+}
+
+// select fastest codec of bit mask
+actor_compression_codec_t actor_compression_select(int codecs) {
+    if (codecs & ACTOR_COMPRESSION_HAS_LZ4) {
+        return ACTOR_COMPRESSION_LZ4;
+    }
+    else if (codecs & ACTOR_COMPRESSION_HAS_ZSTD) {
+        return ACTOR_COMPRESSION_ZSTD;
+    }
+    else if (codecs & ACTOR_COMPRESSION_BUILTIN) {
+        return ACTOR_COMPRESSION_BUILTIN;
+    }
+
+    return ACTOR_COMPRESSION_NONE;
+}
+
+// compress data
+actor_error_t actor_compression_compress(actor_compression_codec_t codec,
+    const char* source, actor_size_t size, char* destination,
+    actor_size_t capacity, actor_size_t* compressed_size) {
+    // check input, sizes are passed to codecs as int
+    if ((source == NULL) || (destination == NULL) || (compressed_size == NULL) ||
+        (size > INT_MAX) || (capacity > INT_MAX)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+#ifdef ACTOR_USE_LZ4
+    if (codec == ACTOR_COMPRESSION_LZ4) {
+        int result = LZ4_compress_default(source, destination, (int)size,
+            (int)capacity);
+
+        if (result <= 0) {
+            return ACTOR_ERROR;
+        }
+
+        *compressed_size = (actor_size_t)result;
+
+        return ACTOR_SUCCESS;
+    }
+#endif
+#ifdef ACTOR_USE_ZSTD
+    if (codec == ACTOR_COMPRESSION_ZSTD) {
+        size_t result = ZSTD_compress(destination, capacity, source, size,
+            ACTOR_COMPRESSION_ZSTD_LEVEL);
+
+        if (ZSTD_isError(result)) {
+            return ACTOR_ERROR;
+        }
+
+        *compressed_size = (actor_size_t)result;
+
+        return ACTOR_SUCCESS;
+    }
+#endif
+    if (codec == ACTOR_COMPRESSION_BUILTIN) {
+        return actor_compression_builtin_compress(source, size, destination,
+            capacity, compressed_size);
+    }
+
+    return ACTOR_ERROR_INVALUE;
+}
+
+// decompress data
+actor_error_t actor_compression_decompress(actor_compression_codec_t codec,
+    const char* source, actor_size_t compressed_size, char* destination,
+    actor_size_t size) {
+    // check input, sizes are passed to codecs as int
+    if ((source == NULL) || (destination == NULL) ||
+        (compressed_size > INT_MAX) || (size > INT_MAX)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+#ifdef ACTOR_USE_LZ4
+    if (codec == ACTOR_COMPRESSION_LZ4) {
+        int result = LZ4_decompress_safe(source, destination,
+            (int)compressed_size, (int)size);
+
+        return result == (int)size ? ACTOR_SUCCESS : ACTOR_ERROR_INVALUE;
+    }
+#endif
+#ifdef ACTOR_USE_ZSTD
+    if (codec == ACTOR_COMPRESSION_ZSTD) {
+        size_t result = ZSTD_decompress(destination, size, source,
+            compressed_size);
+
+        return !ZSTD_isError(result) && (result == size) ?
+            ACTOR_SUCCESS : ACTOR_ERROR_INVALUE;
+    }
+#endif
+    if (codec == ACTOR_COMPRESSION_BUILTIN) {
+        return actor_compression_builtin_decompress(source, compressed_size,
+            destination, size);
+    }
+
+    return ACTOR_ERROR_INVALUE;
+}
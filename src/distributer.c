@@ -19,258 +19,2774 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <netdb.h>
+#include <stdio.h>
 #include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <sched.h>
 #include "../include/actor.h"
 
-// message send process
-actor_error_t actor_distributer_message_send(actor_process_t self, int sock) {
+// epoll is used on linux, poll on all other systems
+#ifdef __linux__
+#include <sys/epoll.h>
+#define ACTOR_DISTRIBUTER_EPOLL
+#else
+#include <poll.h>
+#endif
+
+// flags of socket writes
+#ifdef MSG_NOSIGNAL
+#define ACTOR_DISTRIBUTER_SEND_FLAGS (MSG_NOSIGNAL)
+#else
+#define ACTOR_DISTRIBUTER_SEND_FLAGS (0)
+#endif
+
+// maximum number of events handled per reactor iteration
+#define ACTOR_DISTRIBUTER_MAX_EVENTS (64)
+
+// maximum number of reads or batches per connection and reactor iteration
+#define ACTOR_DISTRIBUTER_MAX_ROUNDS (16)
+
+// time in seconds an accepted peer has to complete its handshake
+#define ACTOR_DISTRIBUTER_HANDSHAKE_TIMEOUT (10.0)
+
+// number of remembered peers of a listener for waiting listen calls
+#define ACTOR_DISTRIBUTER_ACCEPTED_HISTORY (64)
+
+// kinds of poller contexts, each context struct starts with its kind
+#define ACTOR_DISTRIBUTER_WAKEUP (0)
+#define ACTOR_DISTRIBUTER_CONNECTION (1)
+#define ACTOR_DISTRIBUTER_LISTENER (2)
+#define ACTOR_DISTRIBUTER_HANDSHAKE (3)
+
+// length of shared memory names sent in the handshake
+#define ACTOR_DISTRIBUTER_SHM_NAME_SIZE (32)
+
+// transport flags of hello
+#define ACTOR_DISTRIBUTER_HELLO_SHM (0x01)
+
+// prefix of unix domain socket endpoints
+#define ACTOR_DISTRIBUTER_UNIX_PREFIX "unix:"
+
+// maximum length of unix domain socket paths including terminator
+#define ACTOR_DISTRIBUTER_PATH_SIZE (sizeof(((struct sockaddr_un*)NULL)->sun_path))
+
+// maximum number of file descriptors passed with one batch
+#define ACTOR_DISTRIBUTER_MAX_BATCH_FDS (16)
+
+// maximum number of received file descriptors waiting for their frames
+#define ACTOR_DISTRIBUTER_MAX_RECEIVED_FDS (4 * ACTOR_DISTRIBUTER_MAX_BATCH_FDS)
+
+// byte order of host
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define ACTOR_DISTRIBUTER_BIG_ENDIAN (true)
+#else
+#define ACTOR_DISTRIBUTER_BIG_ENDIAN (false)
+#endif
+
+// hello of peer, received after key
+typedef struct {
+    actor_node_id_t nid;
+    bool big_endian;
+    int codecs;
+    int flags;
+    unsigned long long host_id;
+} actor_distributer_hello_s;
+typedef actor_distributer_hello_s* actor_distributer_hello_t;
+
+// shared memory ring
+//
+// Connections to nodes on the same host exchange frames through a pair of
+// rings instead of the socket. The producer owns the tail, the consumer the
+// head. A side, which waits for data or space, sets its flag before checking
+// the ring again, the other side then rings the doorbell by sending a byte
+// over the socket, which also reports a closed connection.
+typedef struct {
+    unsigned long long head;
+    char head_padding[56];
+    unsigned long long tail;
+    char tail_padding[56];
+    long reader_sleeping;
+    long writer_waiting;
+    char flags_padding[48];
+    char data[ACTOR_DISTRIBUTER_SHM_RING_SIZE];
+} actor_distributer_ring_s;
+typedef actor_distributer_ring_s* actor_distributer_ring_t;
+
+// event of poller
+typedef struct {
+    void* context;
+    bool readable;
+    bool writable;
+} actor_distributer_event_s;
+typedef actor_distributer_event_s* actor_distributer_event_t;
+
+// connection to remote node
+//
+// Messages to the remote node are routed to the message queue of the
+// connection, which is registered like a process. The queue notifies the
+// reactor instead of a waiting process. Scalar payloads are only converted
+// to network byte order, if the byte order of the peer differs. Compressed
+// payloads are kept in their own buffer until the batch is sent. Frames to
+// nodes on the same host are written to a shared memory ring, unless the
+// nodes are connected by a unix domain socket. Such a connection passes the
+// file descriptors of a batch with its first bytes, so they are always
+// received before their frames and are matched to them in order. A
+// received message, which does not fit into the full mailbox of its
+// destination, is kept as blocked message and the connection stops reading
+// until it is delivered, so a slow process throttles its sender through the
+// socket or ring instead of growing its mailbox.
+typedef struct actor_distributer_connection_s {
+    int kind;
+    struct actor_distributer_connection_s* next;
+    struct actor_distributer_s* distributer;
+    actor_node_id_t nid;
+    int sock;
+    actor_process_id_t pid;
+    actor_message_queue_t queue;
+    long notified;
+    bool closing;
+    bool closed;
+    bool writable_wanted;
+    bool network_order;
+    bool unix_socket;
+    actor_compression_codec_t codec;
+    unsigned char headers[ACTOR_DISTRIBUTER_MAX_BATCH_SIZE][ACTOR_DISTRIBUTER_MAX_HEADER_SIZE];
+    actor_message_t messages[ACTOR_DISTRIBUTER_MAX_BATCH_SIZE];
+    char* buffers[ACTOR_DISTRIBUTER_MAX_BATCH_SIZE];
+    void* shm;
+    actor_distributer_ring_t send_ring;
+    actor_distributer_ring_t receive_ring;
+    struct iovec iov[2 * ACTOR_DISTRIBUTER_MAX_BATCH_SIZE];
+    actor_size_t batch_count;
+    actor_size_t iov_position;
+    int send_fds[ACTOR_DISTRIBUTER_MAX_BATCH_FDS];
+    actor_size_t send_fd_count;
+    bool send_fds_passed;
+    int received_fds[ACTOR_DISTRIBUTER_MAX_RECEIVED_FDS];
+    actor_size_t received_fd_start;
+    actor_size_t received_fd_count;
+    actor_time_t flush_time;
+    char* buffer;
+    actor_size_t buffer_start;
+    actor_size_t buffer_end;
+    actor_distributer_header_s large_header;
+    char* large_data;
+    actor_size_t large_received;
+    actor_message_t blocked_message;
+} actor_distributer_connection_s;
+typedef actor_distributer_connection_s* actor_distributer_connection_t;
+
+// listening socket
+//
+// A listener stays open until the node is released and accepts any number
+// of peers on its port, or on its path for unix domain sockets. Listen calls
+// wait for the accepted count to change and pick the peer from the history.
+typedef struct actor_distributer_listener_s {
+    int kind;
+    struct actor_distributer_listener_s* next;
+    struct actor_distributer_s* distributer;
+    int sock;
+    unsigned int port;
+    char path[ACTOR_DISTRIBUTER_PATH_SIZE];
+    char key[ACTOR_DISTRIBUTER_KEYLENGTH + 1];
+    bool registered;
+    unsigned long accepted;
+    actor_node_id_t accepted_nids[ACTOR_DISTRIBUTER_ACCEPTED_HISTORY];
+} actor_distributer_listener_s;
+typedef actor_distributer_listener_s* actor_distributer_listener_t;
+
+// handshake of accepted peer
+//
+// The key, hello and ring name of the peer are received without blocking,
+// so all pending handshakes progress concurrently in the reactor.
+typedef struct actor_distributer_handshake_s {
+    int kind;
+    struct actor_distributer_handshake_s* next;
+    actor_distributer_listener_t listener;
+    int sock;
+    unsigned char buffer[ACTOR_DISTRIBUTER_KEYLENGTH + 1 +
+        ACTOR_DISTRIBUTER_HELLO_SIZE + ACTOR_DISTRIBUTER_SHM_NAME_SIZE];
+    actor_size_t received;
+    actor_size_t expected;
+    actor_distributer_hello_s peer;
+    actor_time_t deadline;
+} actor_distributer_handshake_s;
+typedef actor_distributer_handshake_s* actor_distributer_handshake_t;
+
+// distributer struct
+//
+// A reactor thread per node serves all connections and listeners with non
+// blocking sockets. Other threads hand over new connections through the
+// added list, new listeners through the listeners list, and wake up the
+// reactor with a byte on the wakeup pipe.
+struct actor_distributer_s {
+    int kind;
+    actor_node_t node;
+    pthread_t thread;
+    bool started;
+    bool running;
+    pthread_mutex_t lock;
+    pthread_cond_t accepted_condition;
+    int wakeup[2];
+    actor_distributer_connection_t added;
+    actor_distributer_connection_t connections;
+    actor_distributer_connection_t closed;
+    actor_distributer_listener_t listeners;
+    actor_distributer_handshake_t handshakes;
+    actor_distributer_stats_s stats;
+    unsigned long long host_id;
+    long space_notified;
+#ifdef ACTOR_DISTRIBUTER_EPOLL
+    int epoll;
+#else
+    struct pollfd* poll_fds;
+    void** poll_contexts;
+    actor_size_t poll_count;
+    actor_size_t poll_capacity;
+#endif
+};
+
+// current time in seconds
+static actor_time_t actor_distributer_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (actor_time_t)now.tv_sec + (actor_time_t)now.tv_nsec /
+        (actor_time_t)NSEC_PER_SEC;
+}
+
+// set socket to non blocking mode
+static actor_error_t actor_distributer_set_nonblocking(int sock) {
+    int flags = fcntl(sock, F_GETFL, 0);
+
+    if ((flags == -1) || (fcntl(sock, F_SETFL, flags | O_NONBLOCK) == -1)) {
+        return ACTOR_ERROR_NETWORK;
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// write varint, returns number of bytes
+static actor_size_t actor_distributer_put_varint(unsigned char* data,
+    unsigned int value) {
+    actor_size_t length = 0;
+
+    while (value >= 0x80) {
+        data[length++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    data[length++] = (unsigned char)value;
+
+    return length;
+}
+
+// read varint, returns number of bytes, 0 for incomplete and -1 for
+// malformed varint
+static int actor_distributer_get_varint(const unsigned char* data,
+    actor_size_t available, unsigned int* value) {
+    *value = 0;
+
+    for (actor_size_t i = 0; i < 5; i++) {
+        if (i == available) {
+            return 0;
+        }
+
+        *value |= (unsigned int)(data[i] & 0x7f) << (7 * i);
+
+        if ((data[i] & 0x80) == 0) {
+            return (int)i + 1;
+        }
+    }
+
+    return -1;
+}
+
+// map signed to unsigned integer, which keeps small negative values short
+static unsigned int actor_distributer_zigzag(int value) {
+    return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+}
+
+static int actor_distributer_unzigzag(unsigned int value) {
+    return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+// adler-32 checksum of payload
+static unsigned int actor_distributer_checksum(const char* data,
+    actor_size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    unsigned int a = 1, b = 0;
+
+    while (size > 0) {
+        // reduce before sums overflow
+        actor_size_t block = size < 5552 ? size : 5552;
+        size -= block;
+
+        while (block-- > 0) {
+            a += *bytes++;
+            b += a;
+        }
+
+        a %= 65521;
+        b %= 65521;
+    }
+
+    return (b << 16) | a;
+}
+
+// element size of scalar types on the wire, which are sent in network byte
+// order, or 0 for types sent as raw bytes
+static actor_size_t actor_distributer_scalar_size(actor_data_type_t type) {
+    switch (type) {
+        case ACTOR_TYPE_SHORT:
+        case ACTOR_TYPE_USHORT:
+            return sizeof(short);
+
+        case ACTOR_TYPE_INT:
+        case ACTOR_TYPE_UINT:
+            return sizeof(int);
+
+        case ACTOR_TYPE_LONG:
+        case ACTOR_TYPE_ULONG:
+            return ACTOR_DISTRIBUTER_LONG_SIZE;
+
+        case ACTOR_TYPE_LONGLONG:
+        case ACTOR_TYPE_ULONGLONG:
+            return sizeof(long long);
+
+        case ACTOR_TYPE_FLOAT:
+            return sizeof(float);
+
+        case ACTOR_TYPE_DOUBLE:
+            return sizeof(double);
+
+        default:
+            return 0;
+    }
+}
+
+// size of payload on the wire, long elements are resized to the wire size,
+// trailing bytes of an incomplete element are dropped then
+static actor_size_t actor_distributer_wire_size(actor_data_type_t type,
+    actor_size_t size) {
+    if ((sizeof(long) != ACTOR_DISTRIBUTER_LONG_SIZE) &&
+        ((type == ACTOR_TYPE_LONG) || (type == ACTOR_TYPE_ULONG))) {
+        return size / sizeof(long) * ACTOR_DISTRIBUTER_LONG_SIZE;
+    }
+
+    return size;
+}
+
+// copy payload of host into destination of wire size, long elements are
+// widened with their sign
+static void actor_distributer_encode_payload(actor_data_type_t type,
+    const char* source, actor_size_t size, char* destination) {
+    // copy payload of same size
+    if (actor_distributer_wire_size(type, size) == size) {
+        memcpy(destination, source, size);
+
+        return;
+    }
+
+    for (actor_size_t i = 0; i < size / sizeof(long); i++) {
+        if (type == ACTOR_TYPE_LONG) {
+            long value;
+            memcpy(&value, &source[i * sizeof(long)], sizeof(long));
+            long long wide = value;
+            memcpy(&destination[i * ACTOR_DISTRIBUTER_LONG_SIZE], &wide,
+                ACTOR_DISTRIBUTER_LONG_SIZE);
+        }
+        else {
+            unsigned long value;
+            memcpy(&value, &source[i * sizeof(long)], sizeof(long));
+            unsigned long long wide = value;
+            memcpy(&destination[i * ACTOR_DISTRIBUTER_LONG_SIZE], &wide,
+                ACTOR_DISTRIBUTER_LONG_SIZE);
+        }
+    }
+}
+
+// narrow long elements of received payload in place to the long size of
+// the host, returns size of payload on the host
+static actor_size_t actor_distributer_decode_payload(actor_data_type_t type,
+    char* data, actor_size_t size) {
+    // keep payload of same size
+    if (actor_distributer_wire_size(type, sizeof(long)) == sizeof(long)) {
+        return size;
+    }
+
+    actor_size_t count = size / ACTOR_DISTRIBUTER_LONG_SIZE;
+    for (actor_size_t i = 0; i < count; i++) {
+        unsigned long long wide;
+        memcpy(&wide, &data[i * ACTOR_DISTRIBUTER_LONG_SIZE],
+            ACTOR_DISTRIBUTER_LONG_SIZE);
+        unsigned long value = (unsigned long)wide;
+        memcpy(&data[i * sizeof(long)], &value, sizeof(long));
+    }
+
+    return count * sizeof(long);
+}
+
+// convert scalar payload between host and network byte order
+static void actor_distributer_swap_payload(actor_data_type_t type, char* data,
+    actor_size_t size) {
+    // network byte order equals host byte order
+    if (ACTOR_DISTRIBUTER_BIG_ENDIAN) {
+        return;
+    }
+
+    actor_size_t element_size = actor_distributer_scalar_size(type);
+
+    for (actor_size_t i = 0; (element_size > 1) && (i + element_size <= size);
+        i += element_size) {
+        if (element_size == 2) {
+            unsigned short value;
+            memcpy(&value, &data[i], 2);
+            value = __builtin_bswap16(value);
+            memcpy(&data[i], &value, 2);
+        }
+        else if (element_size == 4) {
+            unsigned int value;
+            memcpy(&value, &data[i], 4);
+            value = __builtin_bswap32(value);
+            memcpy(&data[i], &value, 4);
+        }
+        else if (element_size == 8) {
+            unsigned long long value;
+            memcpy(&value, &data[i], 8);
+            value = __builtin_bswap64(value);
+            memcpy(&data[i], &value, 8);
+        }
+    }
+}
+
+// encode frame header, returns number of bytes
+static actor_size_t actor_distributer_encode_header(unsigned char* data,
+    actor_distributer_header_t header) {
+    actor_size_t length = 0;
+
+    data[length++] = (unsigned char)((ACTOR_DISTRIBUTER_VERSION << 4) |
+        header->flags);
+    length += actor_distributer_put_varint(&data[length],
+        actor_distributer_zigzag(header->dest_id));
+    length += actor_distributer_put_varint(&data[length],
+        actor_distributer_zigzag(header->type));
+    length += actor_distributer_put_varint(&data[length], header->message_size);
+
+    if (header->flags & ACTOR_DISTRIBUTER_FRAME_COMPRESSED) {
+        length += actor_distributer_put_varint(&data[length],
+            header->original_size);
+    }
+
+    if (header->flags & ACTOR_DISTRIBUTER_FRAME_ROUTED) {
+        length += actor_distributer_put_varint(&data[length],
+            actor_distributer_zigzag(header->source_nid));
+        length += actor_distributer_put_varint(&data[length],
+            actor_distributer_zigzag(header->source_pid));
+        length += actor_distributer_put_varint(&data[length],
+            (header->correlation_id << 1) | (header->reply ? 1 : 0));
+        length += actor_distributer_put_varint(&data[length],
+            (unsigned int)header->priority);
+    }
+
+    if (header->flags & ACTOR_DISTRIBUTER_FRAME_CHECKSUM) {
+        unsigned int checksum = htonl(header->checksum);
+        memcpy(&data[length], &checksum, sizeof(unsigned int));
+        length += sizeof(unsigned int);
+    }
+
+    return length;
+}
+
+// decode frame header, returns timeout for incomplete header
+static actor_error_t actor_distributer_decode_header(const unsigned char* data,
+    actor_size_t available, actor_distributer_header_t header,
+    actor_size_t* lengthPointer) {
+    if (available == 0) {
+        return ACTOR_ERROR_TIMEOUT;
+    }
+
+    // check version
+    if ((data[0] >> 4) != ACTOR_DISTRIBUTER_VERSION) {
+        return ACTOR_ERROR_NETWORK;
+    }
+    header->flags = data[0] & 0x0f;
+
+    // read varints
+    unsigned int values[8];
+    int value_count = 3;
+    if (header->flags & ACTOR_DISTRIBUTER_FRAME_COMPRESSED) {
+        value_count++;
+    }
+    if (header->flags & ACTOR_DISTRIBUTER_FRAME_ROUTED) {
+        value_count += 4;
+    }
+    actor_size_t length = 1;
+    for (int i = 0; i < value_count; i++) {
+        int varint_length = actor_distributer_get_varint(&data[length],
+            available - length, &values[i]);
+
+        if (varint_length == 0) {
+            return ACTOR_ERROR_TIMEOUT;
+        }
+        else if (varint_length < 0) {
+            return ACTOR_ERROR_NETWORK;
+        }
+
+        length += varint_length;
+    }
+    header->dest_id = actor_distributer_unzigzag(values[0]);
+    header->type = actor_distributer_unzigzag(values[1]);
+    header->message_size = values[2];
+    header->original_size = values[2];
+    if (header->flags & ACTOR_DISTRIBUTER_FRAME_COMPRESSED) {
+        header->original_size = values[3];
+    }
+
+    // get source, correlation and priority of routed frame
+    header->source_nid = ACTOR_INVALID_ID;
+    header->source_pid = ACTOR_INVALID_ID;
+    header->correlation_id = 0;
+    header->reply = false;
+    header->priority = ACTOR_MESSAGE_PRIORITY_NORMAL;
+    if (header->flags & ACTOR_DISTRIBUTER_FRAME_ROUTED) {
+        header->source_nid = actor_distributer_unzigzag(values[value_count - 4]);
+        header->source_pid = actor_distributer_unzigzag(values[value_count - 3]);
+        header->correlation_id = values[value_count - 2] >> 1;
+        header->reply = (values[value_count - 2] & 1) != 0;
+        if (values[value_count - 1] >= ACTOR_MESSAGE_QUEUE_LANE_COUNT) {
+            return ACTOR_ERROR_NETWORK;
+        }
+        header->priority = (actor_message_priority_t)values[value_count - 1];
+    }
+
+    // read checksum
+    header->checksum = 0;
+    if (header->flags & ACTOR_DISTRIBUTER_FRAME_CHECKSUM) {
+        if (available - length < sizeof(unsigned int)) {
+            return ACTOR_ERROR_TIMEOUT;
+        }
+
+        memcpy(&header->checksum, &data[length], sizeof(unsigned int));
+        header->checksum = ntohl(header->checksum);
+        length += sizeof(unsigned int);
+    }
+
+    *lengthPointer = length;
+
+    return ACTOR_SUCCESS;
+}
+
+// encode hello of node
+static void actor_distributer_encode_hello(unsigned char* data,
+    actor_distributer_t distributer) {
+    unsigned int network_nid = htonl((unsigned int)distributer->node->id);
+
+    data[0] = ACTOR_DISTRIBUTER_VERSION;
+    data[1] = ACTOR_DISTRIBUTER_BIG_ENDIAN ? 1 : 0;
+    data[2] = ACTOR_COMPRESSION_SUPPORTED;
+    data[3] = ACTOR_DISTRIBUTER_HELLO_SHM;
+    memcpy(&data[4], &network_nid, sizeof(unsigned int));
+
+    for (int i = 0; i < 8; i++) {
+        data[8 + i] = (unsigned char)(distributer->host_id >> (56 - 8 * i));
+    }
+}
+
+// decode hello of peer
+static actor_error_t actor_distributer_decode_hello(const unsigned char* data,
+    actor_distributer_hello_t hello) {
+    // check version
+    if (data[0] != ACTOR_DISTRIBUTER_VERSION) {
+        return ACTOR_ERROR_NETWORK;
+    }
+
+    unsigned int network_nid;
+    memcpy(&network_nid, &data[4], sizeof(unsigned int));
+
+    hello->nid = (actor_node_id_t)ntohl(network_nid);
+    hello->big_endian = data[1] != 0;
+    hello->codecs = data[2];
+    hello->flags = data[3];
+    hello->host_id = 0;
+    for (int i = 0; i < 8; i++) {
+        hello->host_id = (hello->host_id << 8) | data[8 + i];
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// id of host, which is the same for all nodes sharing the kernel
+static unsigned long long actor_distributer_get_host_id(void) {
+    char id[128];
+    memset(id, 0, sizeof(id));
+
+    // boot id of linux kernel, or host name on other systems
+    int fd = open("/proc/sys/kernel/random/boot_id", O_RDONLY);
+    if ((fd == -1) || (read(fd, id, sizeof(id) - 1) <= 0)) {
+        gethostname(id, sizeof(id) - 1);
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+
+    // fnv-1a hash
+    unsigned long long hash = 14695981039346656037ull ^ (unsigned long long)gethostid();
+    for (size_t i = 0; id[i] != '\0'; i++) {
+        hash = (hash ^ (unsigned char)id[i]) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+// check for unix domain socket
+static bool actor_distributer_is_unix_socket(int sock) {
+    struct sockaddr_storage address;
+    socklen_t length = sizeof(struct sockaddr_storage);
+
+    return (getsockname(sock, (struct sockaddr*)&address, &length) == 0) &&
+        (address.ss_family == AF_UNIX);
+}
+
+// check for peer on the same host, which is not connected by a unix domain
+// socket passing file descriptors in order with the frames
+static bool actor_distributer_use_shm(actor_distributer_t distributer,
+    actor_distributer_hello_t peer, int sock) {
+    return (peer->flags & ACTOR_DISTRIBUTER_HELLO_SHM) &&
+        (peer->host_id == distributer->host_id) &&
+        !actor_distributer_is_unix_socket(sock);
+}
+
+// create shared memory of ring pair, its name is sent to the peer
+static actor_error_t actor_distributer_shm_create(char* name,
+    void** shmPointer) {
+    static long counter = 0;
+    snprintf(name, ACTOR_DISTRIBUTER_SHM_NAME_SIZE, "/libactor-%d-%ld",
+        (int)getpid(), __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED));
+
+    // create zero filled memory
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd == -1) {
+        return ACTOR_ERROR_NETWORK;
+    }
+
+    if (ftruncate(fd, 2 * sizeof(actor_distributer_ring_s)) == -1) {
+        close(fd);
+        shm_unlink(name);
+
+        return ACTOR_ERROR_NETWORK;
+    }
+
+    // map memory
+    void* shm = mmap(NULL, 2 * sizeof(actor_distributer_ring_s),
+        PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (shm == MAP_FAILED) {
+        shm_unlink(name);
+
+        return ACTOR_ERROR_NETWORK;
+    }
+
+    *shmPointer = shm;
+
+    return ACTOR_SUCCESS;
+}
+
+// open shared memory of ring pair created by peer
+static actor_error_t actor_distributer_shm_open(const char* name,
+    void** shmPointer) {
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd == -1) {
+        return ACTOR_ERROR_NETWORK;
+    }
+
+    // check size
+    struct stat info;
+    if ((fstat(fd, &info) == -1) ||
+        (info.st_size != (off_t)(2 * sizeof(actor_distributer_ring_s)))) {
+        close(fd);
+
+        return ACTOR_ERROR_NETWORK;
+    }
+
+    // map memory
+    void* shm = mmap(NULL, 2 * sizeof(actor_distributer_ring_s),
+        PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (shm == MAP_FAILED) {
+        return ACTOR_ERROR_NETWORK;
+    }
+
+    *shmPointer = shm;
+
+    return ACTOR_SUCCESS;
+}
+
+// unmap shared memory of ring pair
+static void actor_distributer_shm_release(void* shm) {
+    munmap(shm, 2 * sizeof(actor_distributer_ring_s));
+}
+
+// number of bytes available in ring
+static actor_size_t actor_distributer_ring_available(
+    actor_distributer_ring_t ring) {
+    return (actor_size_t)(__atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST) -
+        __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST));
+}
+
+// write io vector to ring, returns number of bytes written
+static actor_size_t actor_distributer_ring_write(actor_distributer_ring_t ring,
+    const struct iovec* iov, actor_size_t count) {
+    unsigned long long tail = ring->tail;
+    unsigned long long space = ACTOR_DISTRIBUTER_SHM_RING_SIZE -
+        (tail - __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST));
+    actor_size_t written = 0;
+
+    for (actor_size_t i = 0; (i < count) && (space > 0); i++) {
+        const char* data = iov[i].iov_base;
+        actor_size_t length = iov[i].iov_len < space ? iov[i].iov_len : space;
+
+        // copy in up to two parts around end of ring
+        actor_size_t offset = (tail + written) & (ACTOR_DISTRIBUTER_SHM_RING_SIZE - 1);
+        actor_size_t first = ACTOR_DISTRIBUTER_SHM_RING_SIZE - offset;
+        first = first < length ? first : length;
+        memcpy(&ring->data[offset], data, first);
+        memcpy(ring->data, &data[first], length - first);
+
+        written += length;
+        space -= length;
+    }
+
+    // publish data
+    __atomic_store_n(&ring->tail, tail + written, __ATOMIC_SEQ_CST);
+
+    return written;
+}
+
+// read from ring, returns number of bytes read
+static actor_size_t actor_distributer_ring_read(actor_distributer_ring_t ring,
+    char* destination, actor_size_t length) {
+    unsigned long long head = ring->head;
+    unsigned long long available = __atomic_load_n(&ring->tail,
+        __ATOMIC_SEQ_CST) - head;
+    length = length < available ? length : (actor_size_t)available;
+
+    // copy in up to two parts around end of ring
+    actor_size_t offset = head & (ACTOR_DISTRIBUTER_SHM_RING_SIZE - 1);
+    actor_size_t first = ACTOR_DISTRIBUTER_SHM_RING_SIZE - offset;
+    first = first < length ? first : length;
+    memcpy(destination, &ring->data[offset], first);
+    memcpy(&destination[first], ring->data, length - first);
+
+    // release space
+    __atomic_store_n(&ring->head, head + length, __ATOMIC_SEQ_CST);
+
+    return length;
+}
+
+#ifdef ACTOR_DISTRIBUTER_EPOLL
+
+// create poller
+static actor_error_t actor_distributer_poller_create(
+    actor_distributer_t distributer) {
+    distributer->epoll = epoll_create(ACTOR_DISTRIBUTER_MAX_EVENTS);
+
+    return distributer->epoll == -1 ? ACTOR_ERROR_NETWORK : ACTOR_SUCCESS;
+}
+
+// cleanup poller
+static void actor_distributer_poller_release(actor_distributer_t distributer) {
+    if (distributer->epoll != -1) {
+        close(distributer->epoll);
+    }
+}
+
+// register socket or change its events
+static actor_error_t actor_distributer_poller_set(
+    actor_distributer_t distributer, int sock, void* context, bool add,
+    bool readable, bool writable) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(struct epoll_event));
+    event.events = (readable ? EPOLLIN : 0) | (writable ? EPOLLOUT : 0);
+    event.data.ptr = context;
+
+    if (epoll_ctl(distributer->epoll, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD,
+        sock, &event) == -1) {
+        return ACTOR_ERROR_NETWORK;
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// unregister socket
+static void actor_distributer_poller_remove(actor_distributer_t distributer,
+    int sock) {
+    struct epoll_event event;
+    epoll_ctl(distributer->epoll, EPOLL_CTL_DEL, sock, &event);
+}
+
+// wait for events, timeout in milliseconds or -1
+static int actor_distributer_poller_wait(actor_distributer_t distributer,
+    actor_distributer_event_t events, int timeout) {
+    struct epoll_event epoll_events[ACTOR_DISTRIBUTER_MAX_EVENTS];
+    int count = epoll_wait(distributer->epoll, epoll_events,
+        ACTOR_DISTRIBUTER_MAX_EVENTS, timeout);
+
+    for (int i = 0; i < count; i++) {
+        events[i].context = epoll_events[i].data.ptr;
+        events[i].readable = (epoll_events[i].events &
+            (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0;
+        events[i].writable = (epoll_events[i].events & EPOLLOUT) != 0;
+    }
+
+    return count < 0 ? 0 : count;
+}
+
+#else
+
+// create poller
+static actor_error_t actor_distributer_poller_create(
+    actor_distributer_t distributer) {
+    distributer->poll_fds = NULL;
+    distributer->poll_contexts = NULL;
+    distributer->poll_count = 0;
+    distributer->poll_capacity = 0;
+
+    return ACTOR_SUCCESS;
+}
+
+// cleanup poller
+static void actor_distributer_poller_release(actor_distributer_t distributer) {
+    if (distributer->poll_fds != NULL) {
+        free(distributer->poll_fds);
+    }
+    if (distributer->poll_contexts != NULL) {
+        free(distributer->poll_contexts);
+    }
+}
+
+// register socket or change its events
+static actor_error_t actor_distributer_poller_set(
+    actor_distributer_t distributer, int sock, void* context, bool add,
+    bool readable, bool writable) {
+    // find registered socket
+    actor_size_t index = 0;
+    while ((index < distributer->poll_count) &&
+        (distributer->poll_fds[index].fd != sock)) {
+        index++;
+    }
+
+    // add new socket
+    if (add) {
+        // grow arrays
+        if (distributer->poll_count == distributer->poll_capacity) {
+            actor_size_t capacity = distributer->poll_capacity == 0 ? 16 :
+                2 * distributer->poll_capacity;
+            struct pollfd* fds = realloc(distributer->poll_fds,
+                sizeof(struct pollfd) * capacity);
+            if (fds == NULL) {
+                return ACTOR_ERROR_MEMORY;
+            }
+            distributer->poll_fds = fds;
+
+            void** contexts = realloc(distributer->poll_contexts,
+                sizeof(void*) * capacity);
+            if (contexts == NULL) {
+                return ACTOR_ERROR_MEMORY;
+            }
+            distributer->poll_contexts = contexts;
+            distributer->poll_capacity = capacity;
+        }
+
+        index = distributer->poll_count;
+        distributer->poll_count++;
+    }
+    else if (index == distributer->poll_count) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // set events
+    distributer->poll_fds[index].fd = sock;
+    distributer->poll_fds[index].events = (readable ? POLLIN : 0) |
+        (writable ? POLLOUT : 0);
+    distributer->poll_fds[index].revents = 0;
+    distributer->poll_contexts[index] = context;
+
+    return ACTOR_SUCCESS;
+}
+
+// unregister socket
+static void actor_distributer_poller_remove(actor_distributer_t distributer,
+    int sock) {
+    for (actor_size_t i = 0; i < distributer->poll_count; i++) {
+        if (distributer->poll_fds[i].fd == sock) {
+            // replace by last socket
+            distributer->poll_count--;
+            distributer->poll_fds[i] =
+                distributer->poll_fds[distributer->poll_count];
+            distributer->poll_contexts[i] =
+                distributer->poll_contexts[distributer->poll_count];
+
+            return;
+        }
+    }
+}
+
+// wait for events, timeout in milliseconds or -1
+static int actor_distributer_poller_wait(actor_distributer_t distributer,
+    actor_distributer_event_t events, int timeout) {
+    if (poll(distributer->poll_fds, distributer->poll_count, timeout) <= 0) {
+        return 0;
+    }
+
+    int count = 0;
+    for (actor_size_t i = 0; (i < distributer->poll_count) &&
+        (count < ACTOR_DISTRIBUTER_MAX_EVENTS); i++) {
+        short revents = distributer->poll_fds[i].revents;
+
+        if (revents != 0) {
+            events[count].context = distributer->poll_contexts[i];
+            events[count].readable = (revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+            events[count].writable = (revents & POLLOUT) != 0;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+#endif
+
+// wake up reactor
+static void actor_distributer_wakeup(actor_distributer_t distributer) {
+    char byte = 0;
+    while ((write(distributer->wakeup[1], &byte, 1) == -1) && (errno == EINTR)) {
+    }
+}
+
+// notify reactor about messages for connection, called by message producers
+static void actor_distributer_notify(void* context) {
+    actor_distributer_connection_t connection = context;
+
+    __atomic_store_n(&connection->notified, 1, __ATOMIC_SEQ_CST);
+    actor_distributer_wakeup(connection->distributer);
+}
+
+// notify reactor about space in a mailbox, which blocked a delivery, called
+// by message consumers, the node keeps the distributer until all calls return
+static void actor_distributer_space(void* context) {
+    actor_node_t node = context;
+
+    __atomic_add_fetch(&node->distributer_notifying, 1, __ATOMIC_SEQ_CST);
+    actor_distributer_t distributer = __atomic_load_n(&node->distributer,
+        __ATOMIC_SEQ_CST);
+    if (distributer != NULL) {
+        __atomic_store_n(&distributer->space_notified, 1, __ATOMIC_SEQ_CST);
+        actor_distributer_wakeup(distributer);
+    }
+    __atomic_sub_fetch(&node->distributer_notifying, 1, __ATOMIC_SEQ_CST);
+}
+
+// release messages of sent or dropped batch
+static void actor_distributer_release_batch(
+    actor_distributer_connection_t connection) {
+    for (actor_size_t i = 0; i < connection->batch_count; i++) {
+        actor_message_release(&connection->messages[i]);
+
+        if (connection->buffers[i] != NULL) {
+            free(connection->buffers[i]);
+            connection->buffers[i] = NULL;
+        }
+    }
+
+    // passed or dropped descriptors belong to the peer now
+    for (actor_size_t i = 0; i < connection->send_fd_count; i++) {
+        close(connection->send_fds[i]);
+    }
+
+    connection->batch_count = 0;
+    connection->iov_position = 0;
+    connection->send_fd_count = 0;
+    connection->send_fds_passed = false;
+}
+
+// free connection memory
+static void actor_distributer_connection_free(
+    actor_distributer_connection_t connection) {
+    if (connection->buffer != NULL) {
+        free(connection->buffer);
+    }
+    if (connection->shm != NULL) {
+        actor_distributer_shm_release(connection->shm);
+    }
+
+    free(connection);
+}
+
+// close connection, its memory is freed at the end of the reactor iteration
+static void actor_distributer_close_connection(
+    actor_distributer_connection_t connection) {
+    // check for already closed connection
+    if (connection->closed) {
+        return;
+    }
+
+    // get distributer
+    actor_distributer_t distributer = connection->distributer;
+    actor_node_t node = distributer->node;
+
+    // close socket
+    actor_distributer_poller_remove(distributer, connection->sock);
+    shutdown(connection->sock, 2);
+    close(connection->sock);
+
+    // invalid connection
+    if (node->remote_nodes[connection->nid] == connection->pid) {
+        node->remote_nodes[connection->nid] = ACTOR_INVALID_ID;
+    }
+
+    // drop unsent messages
+    actor_distributer_release_batch(connection);
+    if (connection->large_data != NULL) {
+        free(connection->large_data);
+        connection->large_data = NULL;
+    }
+    if (connection->blocked_message != NULL) {
+        actor_message_release(&connection->blocked_message);
+    }
+
+    // close received descriptors without frame
+    while (connection->received_fd_count > 0) {
+        close(connection->received_fds[connection->received_fd_start]);
+        connection->received_fd_start = (connection->received_fd_start + 1) %
+            ACTOR_DISTRIBUTER_MAX_RECEIVED_FDS;
+        connection->received_fd_count--;
+    }
+
+    // release message queue with all queued messages
+    actor_node_message_queue_release(node, connection->pid);
+    connection->queue = NULL;
+
+    // unlink connection
+    actor_distributer_connection_t* link = &distributer->connections;
+    while (*link != NULL) {
+        if (*link == connection) {
+            *link = connection->next;
+
+            break;
+        }
+
+        link = &(*link)->next;
+    }
+
+    // free later
+    connection->closed = true;
+    connection->next = distributer->closed;
+    distributer->closed = connection;
+}
+
+// ring doorbell of peer
+static void actor_distributer_ring_doorbell(
+    actor_distributer_connection_t connection) {
+    // a full socket already holds a doorbell
+    char byte = 0;
+    while ((send(connection->sock, &byte, 1, ACTOR_DISTRIBUTER_SEND_FLAGS) == -1) &&
+        (errno == EINTR)) {
+    }
+}
+
+// advance pending batch by sent bytes
+static void actor_distributer_advance_batch(
+    actor_distributer_connection_t connection, size_t bytes_sent) {
+    // keep statistics
+    __atomic_fetch_add(&connection->distributer->stats.bytes_sent,
+        bytes_sent, __ATOMIC_RELAXED);
+
+    // skip completely sent buffers
+    while ((connection->iov_position < 2 * connection->batch_count) &&
+        (bytes_sent >= connection->iov[connection->iov_position].iov_len)) {
+        bytes_sent -= connection->iov[connection->iov_position].iov_len;
+        connection->iov_position++;
+    }
+
+    // advance partially sent buffer
+    if (connection->iov_position < 2 * connection->batch_count) {
+        struct iovec* iov = &connection->iov[connection->iov_position];
+        iov->iov_base = (char*)iov->iov_base + bytes_sent;
+        iov->iov_len -= bytes_sent;
+    }
+}
+
+// write pending batch to shared memory ring, returns timeout, if ring is full
+static actor_error_t actor_distributer_write_batch_shm(
+    actor_distributer_connection_t connection) {
+    actor_distributer_ring_t ring = connection->send_ring;
+
+    while (connection->iov_position < 2 * connection->batch_count) {
+        actor_size_t written = actor_distributer_ring_write(ring,
+            &connection->iov[connection->iov_position],
+            2 * connection->batch_count - connection->iov_position);
+
+        // wait for space, the ring is checked again after setting the flag
+        if (written == 0) {
+            __atomic_store_n(&ring->writer_waiting, 1, __ATOMIC_SEQ_CST);
+
+            if (actor_distributer_ring_available(ring) ==
+                ACTOR_DISTRIBUTER_SHM_RING_SIZE) {
+                return ACTOR_ERROR_TIMEOUT;
+            }
+
+            __atomic_store_n(&ring->writer_waiting, 0, __ATOMIC_SEQ_CST);
+
+            continue;
+        }
+
+        // wake up sleeping reader
+        if (__atomic_load_n(&ring->reader_sleeping, __ATOMIC_SEQ_CST) &&
+            __atomic_exchange_n(&ring->reader_sleeping, 0, __ATOMIC_SEQ_CST)) {
+            actor_distributer_ring_doorbell(connection);
+        }
+
+        actor_distributer_advance_batch(connection, written);
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// write pending batch without blocking, returns timeout, if socket is full
+static actor_error_t actor_distributer_write_batch(
+    actor_distributer_connection_t connection) {
+    // use ring of peer on same host
+    if (connection->shm != NULL) {
+        return actor_distributer_write_batch_shm(connection);
+    }
+
+    // create message header
+    struct msghdr header;
+    memset(&header, 0, sizeof(struct msghdr));
+
+    // control message passing the descriptors of the batch
+    union {
+        struct cmsghdr align;
+        char data[CMSG_SPACE(ACTOR_DISTRIBUTER_MAX_BATCH_FDS * sizeof(int))];
+    } control;
+
+    while (connection->iov_position < 2 * connection->batch_count) {
+        header.msg_iov = &connection->iov[connection->iov_position];
+        header.msg_iovlen = 2 * connection->batch_count - connection->iov_position;
+
+        // attach descriptors to the first sent bytes of the batch
+        if ((connection->send_fd_count > 0) && !connection->send_fds_passed) {
+            actor_size_t fds_size = connection->send_fd_count * sizeof(int);
+            memset(&control, 0, sizeof(control));
+            header.msg_control = control.data;
+            header.msg_controllen = CMSG_SPACE(fds_size);
+
+            struct cmsghdr* message = CMSG_FIRSTHDR(&header);
+            message->cmsg_level = SOL_SOCKET;
+            message->cmsg_type = SCM_RIGHTS;
+            message->cmsg_len = CMSG_LEN(fds_size);
+            memcpy(CMSG_DATA(message), connection->send_fds, fds_size);
+        }
+        else {
+            header.msg_control = NULL;
+            header.msg_controllen = 0;
+        }
+
+        ssize_t bytes_sent = sendmsg(connection->sock, &header,
+            ACTOR_DISTRIBUTER_SEND_FLAGS);
+
+        // check success
+        if (bytes_sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                return ACTOR_ERROR_TIMEOUT;
+            }
+
+            return ACTOR_ERROR_NETWORK;
+        }
+
+        connection->send_fds_passed = true;
+        actor_distributer_advance_batch(connection, bytes_sent);
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// add message to batch of connection, converted or compressed payloads are
+// kept in buffers of the batch, as message data may be shared with other
+// messages and is never written
+static actor_error_t actor_distributer_add_to_batch(
+    actor_distributer_connection_t connection, actor_message_t message) {
+    actor_size_t index = connection->batch_count;
+    actor_node_t node = connection->distributer->node;
+
+    // convert copy of payload to byte order and long size of the wire
+    char* payload = message->data;
+    actor_size_t size = actor_distributer_wire_size(message->type, message->size);
+    bool swapped = connection->network_order &&
+        (actor_distributer_scalar_size(message->type) != 0);
+    bool converted = (size != 0) && (swapped || (size != message->size));
+    if (converted) {
+        payload = malloc(size);
+
+        // check success
+        if (payload == NULL) {
+            return ACTOR_ERROR_MEMORY;
+        }
+
+        actor_distributer_encode_payload(message->type, message->data,
+            message->size, payload);
+        if (swapped) {
+            actor_distributer_swap_payload(message->type, payload, size);
+        }
+        connection->buffers[index] = payload;
+    }
+
     // create header
     actor_distributer_header_s header;
+    header.dest_id = message->destination_pid;
+    header.message_size = size;
+    header.type = message->type;
+    header.flags = 0;
+    header.checksum = 0;
+    header.original_size = size;
+    header.source_nid = message->source_nid;
+    header.source_pid = message->source_pid;
+    header.correlation_id = message->correlation_id;
+    header.reply = message->reply;
+    header.priority = message->priority;
+
+    // route replies to the source process and keep priority
+    if ((message->source_pid != ACTOR_INVALID_ID) ||
+        (message->correlation_id != 0) ||
+        (message->priority != ACTOR_MESSAGE_PRIORITY_NORMAL)) {
+        header.flags |= ACTOR_DISTRIBUTER_FRAME_ROUTED;
+    }
+
+    // pass descriptor with the batch, the payload only reserves its place
+    if (message->type == ACTOR_TYPE_FILE_DESCRIPTOR) {
+        memcpy(&connection->send_fds[connection->send_fd_count], message->data,
+            sizeof(int));
+        connection->send_fd_count++;
+    }
+
+    // tell peer about converted byte order
+    if (swapped) {
+        header.flags |= ACTOR_DISTRIBUTER_FRAME_NETWORK_ORDER;
+    }
+
+    // compress large payload, if the result is smaller
+    actor_size_t threshold = node->distributer_compression_threshold;
+    if ((threshold != 0) && (size >= threshold) &&
+        (connection->codec != ACTOR_COMPRESSION_NONE)) {
+        char* compressed = malloc(size);
+        actor_size_t compressed_size = 0;
+
+        if ((compressed != NULL) && (actor_compression_compress(connection->codec,
+            payload, size, compressed, size - 1,
+            &compressed_size) == ACTOR_SUCCESS)) {
+            if (converted) {
+                free(payload);
+            }
+            connection->buffers[index] = compressed;
+            payload = compressed;
+            header.message_size = compressed_size;
+            header.flags |= ACTOR_DISTRIBUTER_FRAME_COMPRESSED;
+
+            // keep statistics
+            actor_distributer_t distributer = connection->distributer;
+            __atomic_fetch_add(&distributer->stats.frames_compressed, 1,
+                __ATOMIC_RELAXED);
+            __atomic_fetch_add(&distributer->stats.bytes_saved,
+                size - compressed_size, __ATOMIC_RELAXED);
+        }
+        else if (compressed != NULL) {
+            free(compressed);
+        }
+    }
+
+    if (node->distributer_checksum) {
+        header.checksum = actor_distributer_checksum(payload, header.message_size);
+        header.flags |= ACTOR_DISTRIBUTER_FRAME_CHECKSUM;
+    }
+
+    // add header and message to io vector
+    connection->iov[2 * index].iov_base = connection->headers[index];
+    connection->iov[2 * index].iov_len = actor_distributer_encode_header(
+        connection->headers[index], &header);
+    connection->iov[2 * index + 1].iov_base = payload;
+    connection->iov[2 * index + 1].iov_len = header.message_size;
+    connection->messages[index] = message;
+    connection->batch_count++;
+
+    return ACTOR_SUCCESS;
+}
+
+// check descriptor of message, which is only passed by unix domain sockets,
+// a descriptor, which cannot be passed, is closed
+static bool actor_distributer_check_fd(actor_distributer_connection_t connection,
+    actor_message_t message) {
+    // check payload
+    if (message->size != sizeof(int)) {
+        return false;
+    }
+
+    int fd;
+    memcpy(&fd, message->data, sizeof(int));
+
+    if (connection->unix_socket && (fcntl(fd, F_GETFD) != -1)) {
+        return true;
+    }
+
+    close(fd);
+
+    return false;
+}
+
+// update events of connection socket, reading pauses while a message is
+// blocked, connections using rings always watch for the doorbell
+static void actor_distributer_connection_watch(
+    actor_distributer_connection_t connection) {
+    if (connection->shm != NULL) {
+        return;
+    }
+
+    actor_distributer_poller_set(connection->distributer, connection->sock,
+        connection, false, connection->blocked_message == NULL,
+        connection->writable_wanted);
+}
+
+// send queued messages of connection in batches
+static void actor_distributer_connection_send(
+    actor_distributer_connection_t connection) {
+    // get batching settings
+    actor_node_t node = connection->distributer->node;
+    actor_size_t batch_size = node->distributer_batch_size;
+
+    for (actor_size_t round = 0; round < ACTOR_DISTRIBUTER_MAX_ROUNDS; round++) {
+        // wait for writable socket to continue a partially sent batch
+        if (connection->writable_wanted) {
+            return;
+        }
+
+        // collect queued messages into batch
+        while (!connection->closing && (connection->batch_count < batch_size) &&
+            (connection->send_fd_count < ACTOR_DISTRIBUTER_MAX_BATCH_FDS)) {
+            // get message without blocking
+            actor_message_t message = NULL;
+            if (actor_message_queue_get(connection->queue, &message,
+                0.0) != ACTOR_SUCCESS) {
+                break;
+            }
+
+            // on dedicated message close connection after sending batch
+            if ((message->destination_nid == node->id) &&
+                (message->destination_pid == connection->pid)) {
+                actor_message_release(&message);
+                connection->closing = true;
+
+                break;
+            }
+
+            // drop descriptor, which cannot be passed
+            if ((message->type == ACTOR_TYPE_FILE_DESCRIPTOR) &&
+                !actor_distributer_check_fd(connection, message)) {
+                actor_message_release(&message);
+
+                continue;
+            }
+
+            // start flush timer with first message
+            if (connection->batch_count == 0) {
+                connection->flush_time = actor_distributer_now() +
+                    node->distributer_flush_latency;
+            }
+
+            // drop message, which cannot be converted
+            if (actor_distributer_add_to_batch(connection, message) !=
+                ACTOR_SUCCESS) {
+                actor_message_release(&message);
+            }
+        }
+
+        // wait for more messages for an incomplete batch, or for an empty
+        // queue, the queue notifies the reactor about new messages
+        if (!connection->closing && ((connection->batch_count == 0) ||
+            ((connection->batch_count < batch_size) &&
+                (actor_distributer_now() < connection->flush_time)))) {
+            bool armed = false;
+            actor_message_queue_arm(connection->queue, &armed);
+
+            if (armed) {
+                return;
+            }
+
+            continue;
+        }
+
+        // send batch
+        actor_error_t error = actor_distributer_write_batch(connection);
+
+        // wait for writable socket, or for doorbell of ring
+        if (error == ACTOR_ERROR_TIMEOUT) {
+            connection->writable_wanted = true;
+            actor_distributer_connection_watch(connection);
+
+            return;
+        }
+        // close broken connection
+        else if (error != ACTOR_SUCCESS) {
+            actor_distributer_close_connection(connection);
+
+            return;
+        }
+
+        // release sent messages
+        actor_distributer_release_batch(connection);
+
+        // close connection after last batch
+        if (connection->closing) {
+            actor_distributer_close_connection(connection);
+
+            return;
+        }
+    }
+
+    // continue in next reactor iteration
+    __atomic_store_n(&connection->notified, 1, __ATOMIC_SEQ_CST);
+}
+
+// continue partially sent batch on writable socket
+static void actor_distributer_connection_writable(
+    actor_distributer_connection_t connection) {
+    // send rest of batch
+    actor_error_t error = actor_distributer_write_batch(connection);
+
+    // wait for writable socket again
+    if (error == ACTOR_ERROR_TIMEOUT) {
+        return;
+    }
+    // close broken connection
+    else if (error != ACTOR_SUCCESS) {
+        actor_distributer_close_connection(connection);
+
+        return;
+    }
+
+    // stop waiting for writable socket
+    connection->writable_wanted = false;
+    actor_distributer_connection_watch(connection);
+
+    // release sent messages
+    actor_distributer_release_batch(connection);
+
+    // close connection after last batch
+    if (connection->closing) {
+        actor_distributer_close_connection(connection);
+
+        return;
+    }
+
+    // send further messages
+    actor_distributer_connection_send(connection);
+}
+
+// deliver received message, owned data is freed after delivery
+static actor_error_t actor_distributer_deliver(
+    actor_distributer_connection_t connection, actor_distributer_header_t header,
+    char* data, bool owned) {
+    actor_node_t node = connection->distributer->node;
+    actor_error_t error = ACTOR_SUCCESS;
+
+    // verify checksum of payload as sent
+    if ((header->flags & ACTOR_DISTRIBUTER_FRAME_CHECKSUM) &&
+        (actor_distributer_checksum(data, header->message_size) !=
+            header->checksum)) {
+        error = ACTOR_ERROR_NETWORK;
+    }
+    // decompress payload into its own buffer
+    else if (header->flags & ACTOR_DISTRIBUTER_FRAME_COMPRESSED) {
+        char* original = malloc(header->original_size);
+
+        if (original == NULL) {
+            error = ACTOR_ERROR_MEMORY;
+        }
+        else if (actor_compression_decompress(connection->codec, data,
+            header->message_size, original, header->original_size) != ACTOR_SUCCESS) {
+            free(original);
+            error = ACTOR_ERROR_NETWORK;
+        }
+        else {
+            if (owned) {
+                free(data);
+            }
+
+            data = original;
+            owned = true;
+        }
+    }
+
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        if (owned) {
+            free(data);
+        }
+
+        return error;
+    }
+
+    // convert payload to host byte order and long size
+    if (header->flags & ACTOR_DISTRIBUTER_FRAME_NETWORK_ORDER) {
+        actor_distributer_swap_payload(header->type, data, header->original_size);
+    }
+    actor_size_t size = actor_distributer_decode_payload(header->type, data,
+        header->original_size);
+
+    // replace payload by next received descriptor
+    if (header->type == ACTOR_TYPE_FILE_DESCRIPTOR) {
+        if ((size != sizeof(int)) ||
+            (connection->received_fd_count == 0)) {
+            if (owned) {
+                free(data);
+            }
+
+            return ACTOR_ERROR_NETWORK;
+        }
+
+        memcpy(data, &connection->received_fds[connection->received_fd_start],
+            sizeof(int));
+        connection->received_fd_start = (connection->received_fd_start + 1) %
+            ACTOR_DISTRIBUTER_MAX_RECEIVED_FDS;
+        connection->received_fd_count--;
+    }
+
+    // create message, which copies data out of receive buffer, or takes
+    // owned data without copy
+    actor_message_t message = NULL;
+    if (!owned) {
+        error = actor_message_create_pooled(node->message_pool, &message,
+            header->type, data, size);
+    }
+    else {
+        error = actor_message_create_owned(node->message_pool, &message,
+            header->type, data, size, free);
+    }
+
+    // drop message, which cannot be created
+    if (error != ACTOR_SUCCESS) {
+        if (owned) {
+            free(data);
+        }
+
+        return ACTOR_SUCCESS;
+    }
+
+    // set destination, source and correlation
+    message->destination_nid = node->id;
+    message->destination_pid = header->dest_id;
+    message->source_nid = header->source_nid;
+    message->source_pid = header->source_pid;
+    message->correlation_id = header->correlation_id;
+    message->reply = header->reply;
+    message->priority = header->priority;
+
+    // deliver message without blocking the reactor, a message to a full
+    // mailbox is kept until the mailbox notifies about space, a message to a
+    // terminated process is dropped
+    error = actor_node_try_deliver_message_notify(node, message,
+        actor_distributer_space, node);
+    if (error == ACTOR_ERROR_MAILBOX_FULL) {
+        connection->blocked_message = message;
+    }
+    else if (error != ACTOR_SUCCESS) {
+        actor_message_release(&message);
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// parse all complete messages in receive buffer
+static actor_error_t actor_distributer_parse_buffer(
+    actor_distributer_connection_t connection) {
+    // get node and buffer
+    actor_node_t node = connection->distributer->node;
+    char* buffer = connection->buffer;
+
+    // stop at blocked message, following messages stay in buffer
+    while (connection->blocked_message == NULL) {
+        // get header
+        actor_distributer_header_s header;
+        actor_size_t header_length = 0;
+        actor_error_t error = actor_distributer_decode_header(
+            (unsigned char*)&buffer[connection->buffer_start],
+            connection->buffer_end - connection->buffer_start, &header,
+            &header_length);
+
+        // wait for complete header
+        if (error == ACTOR_ERROR_TIMEOUT) {
+            break;
+        }
+        else if (error != ACTOR_SUCCESS) {
+            return error;
+        }
+
+        // reject oversized frame of peer before allocating any buffer, the
+        // original size of a compressed frame is checked as well
+        if ((header.message_size > node->distributer_max_message_size) ||
+            (header.original_size > node->distributer_max_message_size)) {
+            return ACTOR_ERROR_NETWORK;
+        }
+
+        // receive large message directly into its own buffer
+        if (header.message_size > ACTOR_DISTRIBUTER_RECEIVE_BUFFER_SIZE -
+            header_length) {
+            connection->large_data = malloc(header.message_size);
+
+            // check success
+            if (connection->large_data == NULL) {
+                return ACTOR_ERROR_MEMORY;
+            }
+
+            // copy buffered data
+            connection->large_header = header;
+            connection->large_received = connection->buffer_end -
+                connection->buffer_start - header_length;
+            memcpy(connection->large_data, &buffer[connection->buffer_start +
+                header_length], connection->large_received);
+            connection->buffer_start = connection->buffer_end = 0;
+
+            return ACTOR_SUCCESS;
+        }
+
+        // check for complete message
+        if (connection->buffer_end - connection->buffer_start <
+            header_length + header.message_size) {
+            break;
+        }
+
+        // deliver message
+        error = actor_distributer_deliver(connection, &header,
+            &buffer[connection->buffer_start + header_length], false);
+
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            return error;
+        }
+
+        connection->buffer_start += header_length + header.message_size;
+    }
+
+    // move incomplete message to front of buffer
+    if (connection->buffer_start > 0) {
+        memmove(buffer, &buffer[connection->buffer_start],
+            connection->buffer_end - connection->buffer_start);
+        connection->buffer_end -= connection->buffer_start;
+        connection->buffer_start = 0;
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// receive from unix domain socket like recv and keep passed descriptors
+static ssize_t actor_distributer_receive_fds(
+    actor_distributer_connection_t connection, char* destination, size_t length) {
+    // create message header
+    struct iovec iov;
+    iov.iov_base = destination;
+    iov.iov_len = length;
+
+    union {
+        struct cmsghdr align;
+        char data[CMSG_SPACE(ACTOR_DISTRIBUTER_MAX_BATCH_FDS * sizeof(int))];
+    } control;
+
+    struct msghdr header;
+    memset(&header, 0, sizeof(struct msghdr));
+    header.msg_iov = &iov;
+    header.msg_iovlen = 1;
+    header.msg_control = control.data;
+    header.msg_controllen = sizeof(control.data);
+
+    ssize_t bytes_received = recvmsg(connection->sock, &header, 0);
+
+    // check success
+    if (bytes_received < 0) {
+        return bytes_received;
+    }
+
+    // queue descriptors, which are closed with the connection on overflow
+    bool overflow = (header.msg_flags & MSG_CTRUNC) != 0;
+    for (struct cmsghdr* message = CMSG_FIRSTHDR(&header); message != NULL;
+        message = CMSG_NXTHDR(&header, message)) {
+        if ((message->cmsg_level != SOL_SOCKET) ||
+            (message->cmsg_type != SCM_RIGHTS)) {
+            continue;
+        }
+
+        actor_size_t count = (message->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (actor_size_t i = 0; i < count; i++) {
+            int fd;
+            memcpy(&fd, CMSG_DATA(message) + i * sizeof(int), sizeof(int));
+
+            if (connection->received_fd_count == ACTOR_DISTRIBUTER_MAX_RECEIVED_FDS) {
+                close(fd);
+                overflow = true;
+
+                continue;
+            }
+
+            connection->received_fds[(connection->received_fd_start +
+                connection->received_fd_count) % ACTOR_DISTRIBUTER_MAX_RECEIVED_FDS] = fd;
+            connection->received_fd_count++;
+        }
+    }
+
+    // frames of lost descriptors cannot be delivered
+    if (overflow) {
+        errno = EPROTO;
+
+        return -1;
+    }
 
-    // error
-    actor_error_t error = ACTOR_SUCCESS;
+    return bytes_received;
+}
 
-    // message pointer
-    actor_message_t message = NULL;
+// read from socket or ring of connection like recv
+static ssize_t actor_distributer_connection_read(
+    actor_distributer_connection_t connection, char* destination, size_t length) {
+    if ((connection->shm == NULL) && connection->unix_socket) {
+        return actor_distributer_receive_fds(connection, destination, length);
+    }
+    else if (connection->shm == NULL) {
+        return recv(connection->sock, destination, length, 0);
+    }
 
-    // send loop
-    while (true) {
-        // get message
-        actor_message_t message = NULL;
-        error = actor_receive(self, &message, 10.0);
+    // read ring, the ring is checked again after setting the sleeping flag
+    actor_distributer_ring_t ring = connection->receive_ring;
+    actor_size_t bytes_read = actor_distributer_ring_read(ring, destination,
+        length);
 
-        // check error
-        if (error != ACTOR_SUCCESS) {
-            return error;
-        }
+    if (bytes_read == 0) {
+        __atomic_store_n(&ring->reader_sleeping, 1, __ATOMIC_SEQ_CST);
+        bytes_read = actor_distributer_ring_read(ring, destination, length);
 
-        // on dedicated message close connection
-        if ((message->destination_nid == self->nid) &&
-            (message->destination_pid == self->pid)) {
-            // cleanup
-            actor_message_release(&message);
+        if (bytes_read == 0) {
+            errno = EAGAIN;
 
-            break;
+            return -1;
         }
 
-        // create header
-        header.dest_id = message->destination_pid;
-        header.message_size = message->size;
-        header.type = message->type;
+        __atomic_store_n(&ring->reader_sleeping, 0, __ATOMIC_SEQ_CST);
+    }
 
-        // send header
-        if (send(sock, &header, sizeof(actor_distributer_header_s), 0) <= 0) {
-            return ACTOR_ERROR_NETWORK;
-        }
+    // wake up waiting writer
+    if (__atomic_load_n(&ring->writer_waiting, __ATOMIC_SEQ_CST) &&
+        __atomic_exchange_n(&ring->writer_waiting, 0, __ATOMIC_SEQ_CST)) {
+        actor_distributer_ring_doorbell(connection);
+    }
 
-        // send message
-        if (send(sock, message->data, message->size, 0) <= 0) {
-            return ACTOR_ERROR_NETWORK;
+    return bytes_read;
+}
+
+// receive available messages of connection
+static void actor_distributer_connection_receive(
+    actor_distributer_connection_t connection) {
+    // a socket paused for a blocked message only reports hangup or error
+    if (connection->blocked_message != NULL) {
+        if (connection->shm == NULL) {
+            actor_distributer_close_connection(connection);
         }
 
-        // release message
-        actor_message_release(&message);
+        return;
     }
 
-    return ACTOR_SUCCESS;
-}
+    for (actor_size_t round = 0; round < ACTOR_DISTRIBUTER_MAX_ROUNDS; round++) {
+        // receive into large message or receive buffer
+        char* destination = NULL;
+        size_t length = 0;
+        if (connection->large_data != NULL) {
+            destination = &connection->large_data[connection->large_received];
+            length = connection->large_header.message_size -
+                connection->large_received;
+        }
+        else {
+            destination = &connection->buffer[connection->buffer_end];
+            length = ACTOR_DISTRIBUTER_RECEIVE_BUFFER_SIZE - connection->buffer_end;
+        }
 
-// message receive process
-actor_error_t actor_distributer_message_receive(actor_process_t self, int sock) {
-    int bytes_received;
-    actor_distributer_header_s header;
+        ssize_t bytes_received = actor_distributer_connection_read(connection,
+            destination, length);
 
-    // get messages
-    while (true) {
-        // receive header
-        bytes_received = recv(sock, &header,
-            sizeof(actor_distributer_header_s), 0);
+        // keep statistics
+        if (bytes_received > 0) {
+            __atomic_fetch_add(&connection->distributer->stats.bytes_received,
+                bytes_received, __ATOMIC_RELAXED);
+        }
 
         // check for closed connection
         if (bytes_received == 0) {
-            return ACTOR_ERROR_NETWORK;
+            actor_distributer_close_connection(connection);
+
+            return;
         }
-        // check for message error
+        // check for receive error
         else if (bytes_received == -1) {
-            continue;
+            if (errno == EINTR) {
+                continue;
+            }
+            else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                return;
+            }
+
+            actor_distributer_close_connection(connection);
+
+            return;
+        }
+
+        // complete large message
+        if (connection->large_data != NULL) {
+            connection->large_received += bytes_received;
+
+            if (connection->large_received == connection->large_header.message_size) {
+                // deliver message, which takes the large buffer
+                char* data = connection->large_data;
+                connection->large_data = NULL;
+
+                if (actor_distributer_deliver(connection, &connection->large_header,
+                    data, true) != ACTOR_SUCCESS) {
+                    actor_distributer_close_connection(connection);
+
+                    return;
+                }
+            }
         }
+        else {
+            // parse received messages
+            connection->buffer_end += bytes_received;
+            if (actor_distributer_parse_buffer(connection) != ACTOR_SUCCESS) {
+                actor_distributer_close_connection(connection);
+
+                return;
+            }
+        }
+
+        // pause reading until blocked message is delivered
+        if (connection->blocked_message != NULL) {
+            actor_distributer_connection_watch(connection);
+
+            return;
+        }
+    }
+}
+
+// retry delivery of blocked message and continue reading
+static void actor_distributer_connection_resume(
+    actor_distributer_connection_t connection) {
+    // retry delivery, a message to a terminated process is dropped
+    actor_node_t node = connection->distributer->node;
+    actor_error_t error = actor_node_try_deliver_message_notify(node,
+        connection->blocked_message, actor_distributer_space, node);
+    if (error == ACTOR_ERROR_MAILBOX_FULL) {
+        return;
+    }
+    else if (error != ACTOR_SUCCESS) {
+        actor_message_release(&connection->blocked_message);
+    }
+    connection->blocked_message = NULL;
+
+    // deliver messages left in buffer
+    if (actor_distributer_parse_buffer(connection) != ACTOR_SUCCESS) {
+        actor_distributer_close_connection(connection);
+
+        return;
+    }
+    if (connection->blocked_message != NULL) {
+        return;
+    }
 
-        // check correct header
-        if (bytes_received != sizeof(actor_distributer_header_s)) {
+    // continue reading
+    actor_distributer_connection_watch(connection);
+    actor_distributer_connection_receive(connection);
+}
+
+// handle doorbell of connection using rings
+static void actor_distributer_connection_doorbell(
+    actor_distributer_connection_t connection) {
+    // drain doorbell bytes
+    bool closed = false;
+    while (true) {
+        char bytes[64];
+        ssize_t bytes_received = recv(connection->sock, bytes, sizeof(bytes), 0);
+
+        if (bytes_received > 0) {
             continue;
         }
+        else if ((bytes_received == -1) && (errno == EINTR)) {
+            continue;
+        }
+        else if ((bytes_received == -1) &&
+            ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+            break;
+        }
 
-        // create message buffer
-        char* data = malloc(header.message_size);
+        closed = true;
+        break;
+    }
 
-        // total received data
-        actor_size_t total_received = 0;
+    // receive messages, on closed socket all messages written before
+    do {
+        actor_distributer_connection_receive(connection);
+    } while (closed && !connection->closed &&
+        (connection->blocked_message == NULL) &&
+        (actor_distributer_ring_available(connection->receive_ring) > 0));
 
-        // receive message
-        while (true) {
-            // get chunk
-            bytes_received = recv(sock, &data[total_received],
-                header.message_size - total_received, 0);
+    if (connection->closed) {
+        return;
+    }
+    else if (closed) {
+        actor_distributer_close_connection(connection);
 
-            // check for closed connection
-            if (bytes_received == 0) {
-                // cleanup
-                free(data);
+        return;
+    }
+
+    // continue batch waiting for space
+    if (connection->writable_wanted) {
+        actor_distributer_connection_writable(connection);
+    }
+}
+
+// create connection for connected socket and register its message queue,
+// the connection takes the shared memory of rings on success, whose first
+// ring is written by the connecting node
+static actor_error_t actor_distributer_connection_create(
+    actor_distributer_t distributer, actor_distributer_hello_t peer, int sock,
+    void* shm, bool connecting, actor_distributer_connection_t* connectionPointer) {
+    // init connection pointer to NULL
+    *connectionPointer = NULL;
+
+    // create connection struct
+    actor_distributer_connection_t connection =
+        malloc(sizeof(actor_distributer_connection_s));
+
+    // check success
+    if (connection == NULL) {
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // init struct
+    connection->kind = ACTOR_DISTRIBUTER_CONNECTION;
+    connection->next = NULL;
+    connection->distributer = distributer;
+    connection->nid = peer->nid;
+    connection->sock = sock;
+    connection->pid = ACTOR_INVALID_ID;
+    connection->queue = NULL;
+    connection->notified = 0;
+    connection->closing = false;
+    connection->closed = false;
+    connection->writable_wanted = false;
+    connection->network_order = peer->big_endian != ACTOR_DISTRIBUTER_BIG_ENDIAN;
+    connection->unix_socket = actor_distributer_is_unix_socket(sock);
+    connection->codec = actor_compression_select(peer->codecs &
+        ACTOR_COMPRESSION_SUPPORTED);
+    for (actor_size_t i = 0; i < ACTOR_DISTRIBUTER_MAX_BATCH_SIZE; i++) {
+        connection->buffers[i] = NULL;
+    }
+    connection->shm = NULL;
+    connection->send_ring = NULL;
+    connection->receive_ring = NULL;
+    connection->batch_count = 0;
+    connection->iov_position = 0;
+    connection->send_fd_count = 0;
+    connection->send_fds_passed = false;
+    connection->received_fd_start = 0;
+    connection->received_fd_count = 0;
+    connection->flush_time = 0.0;
+    connection->buffer_start = 0;
+    connection->buffer_end = 0;
+    connection->large_data = NULL;
+    connection->large_received = 0;
+    connection->blocked_message = NULL;
+
+    // create receive buffer
+    connection->buffer = malloc(ACTOR_DISTRIBUTER_RECEIVE_BUFFER_SIZE);
+
+    // check success
+    if (connection->buffer == NULL) {
+        actor_distributer_connection_free(connection);
+
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // set socket to non blocking mode
+    if (actor_distributer_set_nonblocking(sock) != ACTOR_SUCCESS) {
+        actor_distributer_connection_free(connection);
+
+        return ACTOR_ERROR_NETWORK;
+    }
+
+    // send small batches without delay, messages are coalesced by reactor
+    if (!connection->unix_socket) {
+        int yes = 1;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(int));
+    }
+
+    // register message queue of connection
+    actor_error_t error = actor_node_get_free_message_queue(distributer->node,
+        &connection->queue, &connection->pid);
+
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        actor_distributer_connection_free(connection);
+
+        return error;
+    }
+
+    // limit queue, so that senders feel a slow remote node, the reactor
+    // itself never blocks on it
+    actor_message_queue_set_capacity(connection->queue,
+        ACTOR_DISTRIBUTER_QUEUE_CAPACITY, ACTOR_MESSAGE_QUEUE_BLOCK,
+        ACTOR_DISTRIBUTER_QUEUE_TIMEOUT);
+
+    // notify reactor about messages
+    connection->queue->notify_function = actor_distributer_notify;
+    connection->queue->notify_context = connection;
+
+    // use rings of peer on same host
+    if (shm != NULL) {
+        actor_distributer_ring_t rings = shm;
+        connection->shm = shm;
+        connection->send_ring = connecting ? &rings[0] : &rings[1];
+        connection->receive_ring = connecting ? &rings[1] : &rings[0];
+    }
+
+    // set connection pointer
+    *connectionPointer = connection;
+
+    return ACTOR_SUCCESS;
+}
+
+// check node id received by handshake
+static bool actor_distributer_check_node_id(actor_node_t node,
+    actor_node_id_t node_id) {
+    return (node_id >= 0) && (node_id < ACTOR_NODE_MAX_REMOTE_NODES) &&
+        (node->remote_nodes[node_id] == ACTOR_INVALID_ID) &&
+        (node_id != node->id);
+}
+
+// close handshake and free its memory
+static void actor_distributer_close_handshake(
+    actor_distributer_handshake_t handshake, bool close_socket) {
+    actor_distributer_t distributer = handshake->listener->distributer;
+
+    // close socket
+    if (close_socket) {
+        actor_distributer_poller_remove(distributer, handshake->sock);
+        close(handshake->sock);
+    }
+
+    // unlink handshake
+    actor_distributer_handshake_t* link = &distributer->handshakes;
+    while (*link != NULL) {
+        if (*link == handshake) {
+            *link = handshake->next;
+
+            break;
+        }
+
+        link = &(*link)->next;
+    }
+
+    free(handshake);
+}
+
+// turn completed handshake into connection
+static void actor_distributer_complete_handshake(
+    actor_distributer_handshake_t handshake, void* shm) {
+    actor_distributer_listener_t listener = handshake->listener;
+    actor_distributer_t distributer = listener->distributer;
+    actor_node_t node = distributer->node;
+    actor_node_id_t node_id = handshake->peer.nid;
+
+    // check node id again, another connection may be established meanwhile
+    actor_distributer_connection_t connection = NULL;
+    if (!actor_distributer_check_node_id(node, node_id) ||
+        (actor_distributer_connection_create(distributer, &handshake->peer,
+            handshake->sock, shm, false, &connection) != ACTOR_SUCCESS)) {
+        if (shm != NULL) {
+            actor_distributer_shm_release(shm);
+        }
+        actor_distributer_close_handshake(handshake, true);
+
+        return;
+    }
+
+    // serve socket as connection
+    connection->next = distributer->connections;
+    distributer->connections = connection;
+    actor_distributer_close_handshake(handshake, false);
 
-                return ACTOR_ERROR_NETWORK;
+    if (actor_distributer_poller_set(distributer, connection->sock,
+        connection, false, true, false) != ACTOR_SUCCESS) {
+        actor_distributer_close_connection(connection);
+
+        return;
+    }
+
+    // route messages for remote node to connection
+    node->remote_nodes[node_id] = connection->pid;
+    __atomic_store_n(&connection->notified, 1, __ATOMIC_SEQ_CST);
+
+    // report peer to waiting listen calls
+    pthread_mutex_lock(&distributer->lock);
+    listener->accepted_nids[listener->accepted %
+        ACTOR_DISTRIBUTER_ACCEPTED_HISTORY] = node_id;
+    listener->accepted++;
+    pthread_cond_broadcast(&distributer->accepted_condition);
+    pthread_mutex_unlock(&distributer->lock);
+}
+
+// receive key and hello of accepted peer, and the name of its rings, if
+// it runs on the same host
+static void actor_distributer_handshake_receive(
+    actor_distributer_handshake_t handshake) {
+    actor_distributer_listener_t listener = handshake->listener;
+    actor_distributer_t distributer = listener->distributer;
+    actor_size_t key_size = ACTOR_DISTRIBUTER_KEYLENGTH + 1;
+    actor_size_t hello_end = key_size + ACTOR_DISTRIBUTER_HELLO_SIZE;
+
+    // receive each part of the handshake separately
+    while (handshake->received < handshake->expected) {
+        ssize_t bytes_received = recv(handshake->sock,
+            &handshake->buffer[handshake->received],
+            handshake->expected - handshake->received, 0);
+
+        // check success
+        if (bytes_received < 0) {
+            if (errno == EINTR) {
+                continue;
             }
-            // check for message error
-            else if (bytes_received == -1) {
-                // cleanup
-                free(data);
-                data = NULL;
+            else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                return;
+            }
+        }
+        if (bytes_received <= 0) {
+            actor_distributer_close_handshake(handshake, true);
 
-                break;
+            return;
+        }
+
+        handshake->received += bytes_received;
+
+        if (handshake->received < handshake->expected) {
+            continue;
+        }
+
+        // check key and send hello, which always fits into the empty send
+        // buffer
+        if (handshake->received == key_size) {
+            unsigned char hello[ACTOR_DISTRIBUTER_HELLO_SIZE];
+            actor_distributer_encode_hello(hello, distributer);
+
+            if ((memcmp(listener->key, handshake->buffer,
+                strlen(listener->key) + 1) != 0) ||
+                (send(handshake->sock, hello, ACTOR_DISTRIBUTER_HELLO_SIZE,
+                    ACTOR_DISTRIBUTER_SEND_FLAGS) != ACTOR_DISTRIBUTER_HELLO_SIZE)) {
+                actor_distributer_close_handshake(handshake, true);
+
+                return;
             }
 
-            // increase total size
-            total_received += bytes_received;
+            handshake->expected = hello_end;
+        }
+        // check hello
+        else if (handshake->received == hello_end) {
+            if ((actor_distributer_decode_hello(&handshake->buffer[key_size],
+                &handshake->peer) != ACTOR_SUCCESS) ||
+                !actor_distributer_check_node_id(distributer->node,
+                    handshake->peer.nid)) {
+                actor_distributer_close_handshake(handshake, true);
+
+                return;
+            }
 
-            // check length
-            if (total_received >= header.message_size) {
-                break;
+            if (actor_distributer_use_shm(distributer, &handshake->peer,
+                handshake->sock)) {
+                handshake->expected = hello_end + ACTOR_DISTRIBUTER_SHM_NAME_SIZE;
             }
         }
+    }
+
+    // open rings created by peer, an empty name or a failure falls back to
+    // the socket
+    void* shm = NULL;
+    if (handshake->expected > hello_end) {
+        char* name = (char*)&handshake->buffer[hello_end];
+        name[ACTOR_DISTRIBUTER_SHM_NAME_SIZE - 1] = '\0';
+
+        if ((name[0] != '\0') &&
+            (actor_distributer_shm_open(name, &shm) != ACTOR_SUCCESS)) {
+            shm = NULL;
+        }
 
-        // send message
-        actor_send(self, self->nid, header.dest_id,
-            header.type, data, header.message_size);
+        char status = shm != NULL ? 1 : 0;
+        if (send(handshake->sock, &status, 1, ACTOR_DISTRIBUTER_SEND_FLAGS) != 1) {
+            if (shm != NULL) {
+                actor_distributer_shm_release(shm);
+            }
+            actor_distributer_close_handshake(handshake, true);
 
-        // free message buffer
-        free(data);
+            return;
+        }
     }
 
-    return ACTOR_SUCCESS;
+    actor_distributer_complete_handshake(handshake, shm);
 }
 
-// connection supervisor
-actor_error_t actor_distributer_connection_supervisor(actor_process_t self,
-    actor_node_id_t remote_node, int sock) {
-    // start send process
-    actor_process_id_t sender = ACTOR_INVALID_ID;
+// accept pending peers of listener and start their handshakes
+static void actor_distributer_listener_accept(
+    actor_distributer_listener_t listener) {
+    actor_distributer_t distributer = listener->distributer;
 
-    // loop
-    while (true) {
-        // receive error message
-        actor_message_t message = NULL;
-        if (actor_receive(self, &message, 10.0) != ACTOR_SUCCESS) {
-            continue;
+    for (int i = 0; i < ACTOR_DISTRIBUTER_MAX_EVENTS; i++) {
+        int sock = accept(listener->sock, NULL, NULL);
+
+        // check success
+        if (sock == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return;
         }
 
-        // check message
-        if (message->type != ACTOR_TYPE_ERROR_MESSAGE) {
-            // cleanup
-            actor_message_release(&message);
+        // create handshake struct
+        actor_distributer_handshake_t handshake =
+            malloc(sizeof(actor_distributer_handshake_s));
+
+        // check success
+        if (handshake == NULL) {
+            close(sock);
 
             continue;
         }
 
-        // cast to error message
-        actor_process_error_message_t error_message =
-            (actor_process_error_message_t)message->data;
+        // init struct
+        handshake->kind = ACTOR_DISTRIBUTER_HANDSHAKE;
+        handshake->listener = listener;
+        handshake->sock = sock;
+        handshake->received = 0;
+        handshake->expected = ACTOR_DISTRIBUTER_KEYLENGTH + 1;
+        handshake->deadline = actor_distributer_now() +
+            ACTOR_DISTRIBUTER_HANDSHAKE_TIMEOUT;
+        handshake->next = distributer->handshakes;
+        distributer->handshakes = handshake;
+
+        // wait for key of peer
+        if ((actor_distributer_set_nonblocking(sock) != ACTOR_SUCCESS) ||
+            (actor_distributer_poller_set(distributer, sock, handshake,
+                true, true, false) != ACTOR_SUCCESS)) {
+            close(sock);
+            actor_distributer_close_handshake(handshake, false);
+        }
+    }
+}
+
+// start serving new connections and listeners
+static void actor_distributer_adopt_connections(
+    actor_distributer_t distributer) {
+    // take added connections and register new listeners
+    pthread_mutex_lock(&distributer->lock);
+    actor_distributer_connection_t connection = distributer->added;
+    distributer->added = NULL;
+
+    for (actor_distributer_listener_t listener = distributer->listeners;
+        listener != NULL; listener = listener->next) {
+        if (!listener->registered && (actor_distributer_poller_set(distributer,
+            listener->sock, listener, true, true, false) == ACTOR_SUCCESS)) {
+            listener->registered = true;
+        }
+    }
+
+    pthread_mutex_unlock(&distributer->lock);
+
+    while (connection != NULL) {
+        actor_distributer_connection_t next = connection->next;
+
+        // register connection
+        connection->next = distributer->connections;
+        distributer->connections = connection;
+
+        if (actor_distributer_poller_set(distributer, connection->sock,
+            connection, true, true, false) != ACTOR_SUCCESS) {
+            actor_distributer_close_connection(connection);
+        }
+        else {
+            // send messages queued before adoption
+            __atomic_store_n(&connection->notified, 1, __ATOMIC_SEQ_CST);
+        }
+
+        connection = next;
+    }
+}
+
+// reactor thread
+static void* actor_distributer_reactor_main(void* context) {
+    actor_distributer_t distributer = context;
+    actor_distributer_event_s events[ACTOR_DISTRIBUTER_MAX_EVENTS];
+
+    // timeout of poller in milliseconds, none initially
+    int timeout = -1;
+
+    while (__atomic_load_n(&distributer->running, __ATOMIC_SEQ_CST)) {
+        // wait for events
+        int count = actor_distributer_poller_wait(distributer, events, timeout);
+
+        // handle events
+        for (int i = 0; i < count; i++) {
+            int kind = *(int*)events[i].context;
+
+            // wakeup
+            if (kind == ACTOR_DISTRIBUTER_WAKEUP) {
+                char bytes[64];
+                while (read(distributer->wakeup[0], bytes, sizeof(bytes)) > 0) {
+                }
+
+                actor_distributer_adopt_connections(distributer);
+
+                continue;
+            }
+
+            // accept new peers
+            if (kind == ACTOR_DISTRIBUTER_LISTENER) {
+                actor_distributer_listener_accept(events[i].context);
+
+                continue;
+            }
+
+            // continue handshake
+            if (kind == ACTOR_DISTRIBUTER_HANDSHAKE) {
+                actor_distributer_handshake_receive(events[i].context);
+
+                continue;
+            }
+
+            // skip connections closed in this iteration
+            actor_distributer_connection_t connection = events[i].context;
+            if (connection->closed) {
+                continue;
+            }
+
+            if (events[i].writable) {
+                actor_distributer_connection_writable(connection);
+            }
+            if (events[i].readable && !connection->closed) {
+                if (connection->shm != NULL) {
+                    actor_distributer_connection_doorbell(connection);
+                }
+                else {
+                    actor_distributer_connection_receive(connection);
+                }
+            }
+        }
+
+        // send messages of notified connections and flush due batches
+        timeout = -1;
+        actor_time_t now = actor_distributer_now();
+        bool space_notified = __atomic_exchange_n(&distributer->space_notified,
+            0, __ATOMIC_SEQ_CST) != 0;
+        actor_distributer_connection_t connection = distributer->connections;
+        while (connection != NULL) {
+            actor_distributer_connection_t next = connection->next;
+
+            // retry delivery of blocked message, once a mailbox has space
+            if (space_notified && (connection->blocked_message != NULL)) {
+                actor_distributer_connection_resume(connection);
+
+                if (connection->closed) {
+                    connection = next;
+
+                    continue;
+                }
+            }
+
+            // continue reading ring, which was not emptied by its last read
+            if ((connection->blocked_message == NULL) &&
+                (connection->shm != NULL) && (__atomic_load_n(
+                &connection->receive_ring->reader_sleeping, __ATOMIC_SEQ_CST) == 0)) {
+                actor_distributer_connection_receive(connection);
+
+                if (connection->closed) {
+                    connection = next;
+
+                    continue;
+                }
+            }
+
+            if ((__atomic_exchange_n(&connection->notified, 0,
+                __ATOMIC_SEQ_CST) != 0) || ((connection->batch_count > 0) &&
+                !connection->writable_wanted && (connection->flush_time <= now))) {
+                actor_distributer_connection_send(connection);
+            }
+
+            connection = next;
+        }
+
+        // calculate timeout for next iteration
+        for (connection = distributer->connections; connection != NULL;
+            connection = connection->next) {
+            int connection_timeout = -1;
+
+            if ((__atomic_load_n(&connection->notified, __ATOMIC_SEQ_CST) != 0) ||
+                ((connection->blocked_message == NULL) && (connection->shm != NULL) &&
+                    (__atomic_load_n(&connection->receive_ring->reader_sleeping,
+                        __ATOMIC_SEQ_CST) == 0))) {
+                connection_timeout = 0;
+            }
+            else if ((connection->batch_count > 0) && !connection->writable_wanted) {
+                // round up to full milliseconds
+                actor_time_t remaining = connection->flush_time -
+                    actor_distributer_now();
+                connection_timeout = remaining > 0.0 ?
+                    (int)(remaining * 1000.0) + 1 : 0;
+            }
+
+            if ((connection_timeout >= 0) &&
+                ((timeout < 0) || (connection_timeout < timeout))) {
+                timeout = connection_timeout;
+            }
+        }
+
+        // close expired handshakes
+        actor_distributer_handshake_t handshake = distributer->handshakes;
+        while (handshake != NULL) {
+            actor_distributer_handshake_t next = handshake->next;
+
+            // round up to full milliseconds
+            actor_time_t remaining = handshake->deadline - actor_distributer_now();
+            if (remaining <= 0.0) {
+                actor_distributer_close_handshake(handshake, true);
+            }
+            else if ((timeout < 0) || ((int)(remaining * 1000.0) + 1 < timeout)) {
+                timeout = (int)(remaining * 1000.0) + 1;
+            }
+
+            handshake = next;
+        }
+
+        // free closed connections
+        while (distributer->closed != NULL) {
+            connection = distributer->closed;
+            distributer->closed = connection->next;
+            actor_distributer_connection_free(connection);
+        }
+    }
+
+    return NULL;
+}
+
+// start reactor thread, called with lock of distributer
+static actor_error_t actor_distributer_start(actor_distributer_t distributer) {
+    if (distributer->started) {
+        return ACTOR_SUCCESS;
+    }
+
+    if (pthread_create(&distributer->thread, NULL,
+        actor_distributer_reactor_main, distributer) != 0) {
+        return ACTOR_ERROR_DISPATCH;
+    }
+
+    distributer->started = true;
+
+    return ACTOR_SUCCESS;
+}
+
+// create distributer
+actor_error_t actor_distributer_create(actor_distributer_t* distributerPointer,
+    actor_node_t node) {
+    // check input
+    if ((distributerPointer == NULL) || (node == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // init distributer pointer to NULL
+    *distributerPointer = NULL;
+
+    // create distributer struct
+    actor_distributer_t distributer = malloc(sizeof(struct actor_distributer_s));
+
+    // check success
+    if (distributer == NULL) {
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // init struct
+    distributer->kind = ACTOR_DISTRIBUTER_WAKEUP;
+    distributer->node = node;
+    distributer->started = false;
+    distributer->running = true;
+    distributer->wakeup[0] = -1;
+    distributer->wakeup[1] = -1;
+    distributer->added = NULL;
+    distributer->connections = NULL;
+    distributer->closed = NULL;
+    distributer->listeners = NULL;
+    distributer->handshakes = NULL;
+    distributer->host_id = actor_distributer_get_host_id();
+    memset(&distributer->stats, 0, sizeof(actor_distributer_stats_s));
+    distributer->space_notified = 0;
+    pthread_mutex_init(&distributer->lock, NULL);
+    pthread_cond_init(&distributer->accepted_condition, NULL);
+
+    // create poller
+    actor_error_t error = actor_distributer_poller_create(distributer);
+
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        actor_distributer_release(&distributer);
+
+        return error;
+    }
+
+    // create wakeup pipe
+    if ((pipe(distributer->wakeup) == -1) ||
+        (actor_distributer_set_nonblocking(distributer->wakeup[0]) != ACTOR_SUCCESS) ||
+        (actor_distributer_set_nonblocking(distributer->wakeup[1]) != ACTOR_SUCCESS) ||
+        (actor_distributer_poller_set(distributer, distributer->wakeup[0],
+            distributer, true, true, false) != ACTOR_SUCCESS)) {
+        actor_distributer_release(&distributer);
+
+        return ACTOR_ERROR_NETWORK;
+    }
+
+    // set distributer pointer
+    *distributerPointer = distributer;
+
+    return ACTOR_SUCCESS;
+}
+
+// cleanup distributer
+actor_error_t actor_distributer_release(actor_distributer_t* distributerPointer) {
+    // check for valid distributer
+    if ((distributerPointer == NULL) || (*distributerPointer == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
 
-        // check error message
-        if (error_message->error == ACTOR_ERROR_TIMEOUT) {
-            // restart sender
-            actor_error_t error = actor_spawn(self->node, &sender,
-                ^actor_error_t(actor_process_t s) {
-                    // set self as supervisor
-                    actor_process_link(s, self->nid, self->pid);
+    // get distributer
+    actor_distributer_t distributer = *distributerPointer;
 
-                    // start send process
-                    return actor_distributer_message_send(s, sock);
-                });
+    // stop reactor
+    if (distributer->started) {
+        __atomic_store_n(&distributer->running, false, __ATOMIC_SEQ_CST);
+        actor_distributer_wakeup(distributer);
+        pthread_join(distributer->thread, NULL);
+    }
 
-            // set new connector
-            self->node->remote_nodes[remote_node] = sender;
+    // detach from node and wait for running space notifications
+    if ((distributer->node != NULL) && __atomic_load_n(
+        &distributer->node->distributer, __ATOMIC_SEQ_CST) == distributer) {
+        __atomic_store_n(&distributer->node->distributer, NULL, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&distributer->node->distributer_notifying,
+            __ATOMIC_SEQ_CST) != 0) {
+            sched_yield();
         }
-        else {
-            // release message
-            actor_message_release(&message);
+    }
 
-            break;
+    // close all listeners and pending handshakes
+    while (distributer->handshakes != NULL) {
+        actor_distributer_close_handshake(distributer->handshakes, true);
+    }
+    while (distributer->listeners != NULL) {
+        actor_distributer_listener_t listener = distributer->listeners;
+        distributer->listeners = listener->next;
+        close(listener->sock);
+        if (listener->path[0] != '\0') {
+            unlink(listener->path);
         }
+        free(listener);
+    }
 
-        // release message
-        actor_message_release(&message);
+    // close all connections
+    actor_distributer_adopt_connections(distributer);
+    while (distributer->connections != NULL) {
+        actor_distributer_close_connection(distributer->connections);
+    }
+    while (distributer->closed != NULL) {
+        actor_distributer_connection_t connection = distributer->closed;
+        distributer->closed = connection->next;
+        actor_distributer_connection_free(connection);
     }
 
-    // close connection
-    shutdown(sock, 2);
+    // close wakeup pipe
+    if (distributer->wakeup[0] != -1) {
+        close(distributer->wakeup[0]);
+    }
+    if (distributer->wakeup[1] != -1) {
+        close(distributer->wakeup[1]);
+    }
 
-    // try close send process
-    actor_distributer_disconnect_from_node(self->node, remote_node);
+    // free memory
+    actor_distributer_poller_release(distributer);
+    pthread_cond_destroy(&distributer->accepted_condition);
+    pthread_mutex_destroy(&distributer->lock);
+    free(distributer);
 
-    // invalid connection
-    self->node->remote_nodes[remote_node] = ACTOR_INVALID_ID;
+    // set distributer pointer to NULL
+    *distributerPointer = NULL;
 
     return ACTOR_SUCCESS;
 }
 
-actor_error_t actor_distributer_start_connectors(actor_node_t node,
-    actor_node_id_t remote_node, int sock) {
+// add connected socket to reactor of node
+static actor_error_t actor_distributer_add_connection(actor_node_t node,
+    actor_distributer_hello_t peer, int sock, void* shm) {
     // check input
     if (node == NULL) {
         return ACTOR_ERROR_INVALUE;
     }
 
-    // error
-    actor_error_t error = ACTOR_SUCCESS;
+    // get distributer
+    actor_distributer_t distributer = node->distributer;
 
-    // start connection supervisor
-    actor_process_id_t supervisor = ACTOR_INVALID_ID;
-    error = actor_spawn(node, &supervisor,
-        ^actor_error_t(actor_process_t self) {
-            return actor_distributer_connection_supervisor(self, remote_node, sock);
-        });
+    // create connection
+    actor_distributer_connection_t connection = NULL;
+    actor_error_t error = actor_distributer_connection_create(distributer,
+        peer, sock, shm, true, &connection);
 
     // check success
     if (error != ACTOR_SUCCESS) {
         return error;
     }
 
-    // start receive process
-    actor_process_id_t receiver = ACTOR_INVALID_ID;
-    error = actor_spawn(node, &receiver,
-        ^actor_error_t(actor_process_t self) {
-            // set self as supervisor
-            actor_process_link(self, self->nid, supervisor);
+    // hand over connection to reactor, which is started with first connection
+    pthread_mutex_lock(&distributer->lock);
 
-            // start receive process
-            return actor_distributer_message_receive(self, sock);
-        });
+    error = actor_distributer_start(distributer);
 
     // check success
     if (error != ACTOR_SUCCESS) {
+        pthread_mutex_unlock(&distributer->lock);
+        actor_node_message_queue_release(node, connection->pid);
+        connection->shm = NULL;
+        actor_distributer_connection_free(connection);
+
         return error;
     }
 
-    // start send process
-    actor_process_id_t sender = ACTOR_INVALID_ID;
-    error = actor_spawn(node, &sender,
-        ^actor_error_t(actor_process_t self) {
-            // set self as supervisor
-            actor_process_link(self, self->nid, supervisor);
+    connection->next = distributer->added;
+    distributer->added = connection;
+
+    pthread_mutex_unlock(&distributer->lock);
+
+    // route messages for remote node to connection
+    node->remote_nodes[peer->nid] = connection->pid;
+
+    // wake up reactor
+    actor_distributer_wakeup(distributer);
+
+    return ACTOR_SUCCESS;
+}
+
+// create socket connected to host and port, or to unix domain socket
+// endpoint, which ignores the port
+static actor_error_t actor_distributer_connect_socket(const char* host_name,
+    unsigned int port, int* sockPointer) {
+    // check input
+    if (host_name == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // connect to unix domain socket
+    actor_size_t prefix_length = strlen(ACTOR_DISTRIBUTER_UNIX_PREFIX);
+    if (strncmp(host_name, ACTOR_DISTRIBUTER_UNIX_PREFIX, prefix_length) == 0) {
+        const char* path = &host_name[prefix_length];
+
+        // check path length
+        if ((path[0] == '\0') || (strlen(path) >= ACTOR_DISTRIBUTER_PATH_SIZE)) {
+            return ACTOR_ERROR_INVALUE;
+        }
+
+        // create client socket
+        int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+
+        // check success
+        if (sock == -1) {
+            return ACTOR_ERROR_NETWORK;
+        }
+
+        // create server address struct
+        struct sockaddr_un server_addr;
+        memset(&server_addr, 0, sizeof(struct sockaddr_un));
+        server_addr.sun_family = AF_UNIX;
+        strcpy(server_addr.sun_path, path);
+
+        // connect
+        if (connect(sock, (struct sockaddr*)&server_addr,
+                sizeof(struct sockaddr_un)) == -1) {
+            close(sock);
+
+            return ACTOR_ERROR_NETWORK;
+        }
+
+        *sockPointer = sock;
+
+        return ACTOR_SUCCESS;
+    }
+
+    // create client socket
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+
+    // check success
+    if (sock == -1) {
+        return ACTOR_ERROR_NETWORK;
+    }
 
-            // start send process
-            return actor_distributer_message_send(self, sock);
-        });
+    // get host address, getaddrinfo is safe for concurrent connects
+    struct addrinfo hints;
+    struct addrinfo* host = NULL;
+    memset(&hints, 0, sizeof(struct addrinfo));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
 
     // check success
-    if (error != ACTOR_SUCCESS) {
-        return error;
+    if ((getaddrinfo(host_name, NULL, &hints, &host) != 0) || (host == NULL)) {
+        close(sock);
+
+        return ACTOR_ERROR_NETWORK;
+    }
+
+    // create server address struct
+    struct sockaddr_in server_addr;
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(port);
+    server_addr.sin_addr = ((struct sockaddr_in*)host->ai_addr)->sin_addr;
+    bzero(&(server_addr.sin_zero),8);
+    freeaddrinfo(host);
+
+    // connect
+    if (connect(sock, (struct sockaddr *)&server_addr,
+            sizeof(struct sockaddr)) == -1) {
+        close(sock);
+
+        return ACTOR_ERROR_NETWORK;
     }
 
-    // init sender as connector
-    node->remote_nodes[remote_node] = sender;
+    *sockPointer = sock;
 
     return ACTOR_SUCCESS;
 }
@@ -278,8 +2794,8 @@ actor_error_t actor_distributer_start_connectors(actor_node_t node,
 // connect to node
 actor_error_t actor_distributer_connect_to_node(actor_node_t node, actor_node_id_t* nid,
     const char* host_name, unsigned int port, const char* key) {
-    // check valid node
-    if (node == NULL) {
+    // check input
+    if ((node == NULL) || (key == NULL)) {
         return ACTOR_ERROR_INVALUE;
     }
 
@@ -293,13 +2809,15 @@ actor_error_t actor_distributer_connect_to_node(actor_node_t node, actor_node_id
         *nid = ACTOR_INVALID_ID;
     }
 
-    // create client socket
+    // connect socket to endpoint
     int bytes_received;
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    int sock = -1;
+    actor_error_t error = actor_distributer_connect_socket(host_name, port,
+        &sock);
 
     // check success
-    if (sock == -1) {
-        return ACTOR_ERROR_NETWORK;
+    if (error != ACTOR_SUCCESS) {
+        return error;
     }
 
     // set recv timeout to 10 sec
@@ -308,87 +2826,236 @@ actor_error_t actor_distributer_connect_to_node(actor_node_t node, actor_node_id
     tv.tv_usec = 0;
     setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (struct timeval*)&tv, sizeof(struct timeval));
 
-    // get host address
-    struct hostent* host = gethostbyname(host_name);
-
-    // create server address struct
-    struct sockaddr_in server_addr;
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port);
-    server_addr.sin_addr = *((struct in_addr *)host->h_addr);
-    bzero(&(server_addr.sin_zero),8);
+    // copy key and hello to static sized buffer
+    unsigned char buffer[ACTOR_DISTRIBUTER_KEYLENGTH + 1 +
+        ACTOR_DISTRIBUTER_HELLO_SIZE];
+    memset(buffer, 0, ACTOR_DISTRIBUTER_KEYLENGTH + 1);
+    strcpy((char*)buffer, key);
+    actor_distributer_encode_hello(&buffer[ACTOR_DISTRIBUTER_KEYLENGTH + 1],
+        node->distributer);
+
+    // send key and hello
+    if (send(sock, buffer, sizeof(buffer), ACTOR_DISTRIBUTER_SEND_FLAGS) !=
+        sizeof(buffer)) {
+        // close connection
+        close(sock);
 
-    // connect
-    if (connect(sock, (struct sockaddr *)&server_addr,
-            sizeof(struct sockaddr)) == -1) {
         return ACTOR_ERROR_NETWORK;
     }
 
-    // copy key to static sized buffer
-    char buffer[ACTOR_DISTRIBUTER_KEYLENGTH + 1];
-    strcpy(buffer, key);
+    // get hello
+    bytes_received = recv(sock, buffer, ACTOR_DISTRIBUTER_HELLO_SIZE, MSG_WAITALL);
 
-    // send key
-    if (send(sock, &buffer, ACTOR_DISTRIBUTER_KEYLENGTH + 1, 0) <= 0) {
+    // check success
+    actor_distributer_hello_s peer;
+    if ((bytes_received != ACTOR_DISTRIBUTER_HELLO_SIZE) ||
+        (actor_distributer_decode_hello(buffer, &peer) != ACTOR_SUCCESS) ||
+        !actor_distributer_check_node_id(node, peer.nid)) {
         // close connection
         close(sock);
 
         return ACTOR_ERROR_NETWORK;
     }
+    actor_node_id_t node_id = peer.nid;
+
+    // create rings for peer on same host, an empty name or a failure of the
+    // peer falls back to the socket
+    void* shm = NULL;
+    if (actor_distributer_use_shm(node->distributer, &peer, sock)) {
+        char name[ACTOR_DISTRIBUTER_SHM_NAME_SIZE];
+        memset(name, 0, ACTOR_DISTRIBUTER_SHM_NAME_SIZE);
+        if (actor_distributer_shm_create(name, &shm) != ACTOR_SUCCESS) {
+            memset(name, 0, ACTOR_DISTRIBUTER_SHM_NAME_SIZE);
+            shm = NULL;
+        }
 
-    // send node id
-    if (send(sock, &node->id, sizeof(actor_node_id_t), 0) <= 0) {
-        // close
-        close(sock);
+        // send name and get status
+        char status = 0;
+        bool success = (send(sock, name, ACTOR_DISTRIBUTER_SHM_NAME_SIZE,
+            ACTOR_DISTRIBUTER_SEND_FLAGS) == ACTOR_DISTRIBUTER_SHM_NAME_SIZE) &&
+            (recv(sock, &status, 1, MSG_WAITALL) == 1);
 
-        return ACTOR_ERROR_NETWORK;
+        // name is not needed after peer has opened the rings
+        if (name[0] != '\0') {
+            shm_unlink(name);
+        }
+
+        if ((shm != NULL) && (!success || (status != 1))) {
+            actor_distributer_shm_release(shm);
+            shm = NULL;
+        }
+
+        // check success
+        if (!success) {
+            // close connection
+            close(sock);
+
+            return ACTOR_ERROR_NETWORK;
+        }
     }
 
-    // get node id
-    actor_node_id_t node_id;
-    bytes_received = recv(sock, &node_id, sizeof(actor_node_id_t), 0);
+    // serve connection by reactor
+    error = actor_distributer_add_connection(node, &peer, sock,
+        shm);
 
     // check success
-    if (bytes_received != sizeof(actor_node_id_t)) {
+    if (error != ACTOR_SUCCESS) {
         // close connection
+        if (shm != NULL) {
+            actor_distributer_shm_release(shm);
+        }
         close(sock);
 
+        return error;
+    }
+
+    // set node id
+    if (nid != NULL) {
+        *nid = node_id;
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// create listening socket bound to port, or to path of unix domain socket
+static actor_error_t actor_distributer_bind_socket(unsigned int port,
+    const char* path, int* sockPointer) {
+    // create server socket
+    int sock = socket(path != NULL ? AF_UNIX : AF_INET, SOCK_STREAM, 0);
+
+    // check success
+    if (sock == -1) {
         return ACTOR_ERROR_NETWORK;
     }
 
-    if ((node_id < 0) || (node_id > ACTOR_NODE_MAX_REMOTE_NODES) ||
-        (node->remote_nodes[node_id] != ACTOR_INVALID_ID) ||
-        (node_id == node->id)) {
-        // close connection
+    // bind socket to address
+    int result = -1;
+    if (path != NULL) {
+        // create server address struct
+        struct sockaddr_un server_addr;
+        memset(&server_addr, 0, sizeof(struct sockaddr_un));
+        server_addr.sun_family = AF_UNIX;
+        strcpy(server_addr.sun_path, path);
+
+        // remove socket file left by a terminated node, a socket file of a
+        // running node accepts the connection
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        if ((probe != -1) && (connect(probe, (struct sockaddr*)&server_addr,
+            sizeof(struct sockaddr_un)) == -1) && (errno == ECONNREFUSED)) {
+            unlink(path);
+        }
+        if (probe != -1) {
+            close(probe);
+        }
+
+        result = bind(sock, (struct sockaddr*)&server_addr,
+            sizeof(struct sockaddr_un));
+    }
+    else {
+        // set socket opts
+        int yes = 1;
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(int));
+
+        // create server address struct
+        struct sockaddr_in server_addr;
+        server_addr.sin_family = AF_INET;
+        server_addr.sin_port = htons(port);
+        server_addr.sin_addr.s_addr = INADDR_ANY;
+        bzero(&(server_addr.sin_zero),8);
+
+        result = bind(sock, (struct sockaddr *)&server_addr, sizeof(struct sockaddr));
+    }
+
+    // start listening
+    if ((result == -1) || (listen(sock, SOMAXCONN) == -1) ||
+        (actor_distributer_set_nonblocking(sock) != ACTOR_SUCCESS)) {
         close(sock);
 
         return ACTOR_ERROR_NETWORK;
     }
 
-    // start connectors
-    actor_error_t error = actor_distributer_start_connectors(node, node_id, sock);
+    *sockPointer = sock;
+
+    return ACTOR_SUCCESS;
+}
+
+// get listener of port or path or create it, called with lock of
+// distributer
+static actor_error_t actor_distributer_get_listener(actor_distributer_t distributer,
+    actor_distributer_listener_t* listenerPointer, unsigned int port,
+    const char* path, const char* key) {
+    // init listener pointer to NULL
+    *listenerPointer = NULL;
+
+    // look for running listener, which must use the same key
+    for (actor_distributer_listener_t listener = distributer->listeners;
+        listener != NULL; listener = listener->next) {
+        if ((path != NULL) ? (strcmp(listener->path, path) == 0) :
+            ((listener->path[0] == '\0') && (listener->port == port))) {
+            if (strcmp(listener->key, key) != 0) {
+                return ACTOR_ERROR_INVALUE;
+            }
+
+            *listenerPointer = listener;
+
+            return ACTOR_SUCCESS;
+        }
+    }
+
+    // start reactor, which accepts the peers
+    actor_error_t error = actor_distributer_start(distributer);
 
     // check success
     if (error != ACTOR_SUCCESS) {
-        // close connection
-        close(sock);
+        return error;
+    }
+
+    // create server socket
+    int sock = -1;
+    error = actor_distributer_bind_socket(port, path, &sock);
 
+    // check success
+    if (error != ACTOR_SUCCESS) {
         return error;
     }
 
-    // set node id
-    if (nid != NULL) {
-        *nid = node_id;
+    // create listener struct
+    actor_distributer_listener_t listener =
+        malloc(sizeof(actor_distributer_listener_s));
+
+    // check success
+    if (listener == NULL) {
+        close(sock);
+        if (path != NULL) {
+            unlink(path);
+        }
+
+        return ACTOR_ERROR_MEMORY;
     }
 
+    // init struct, the socket is registered by the reactor
+    listener->kind = ACTOR_DISTRIBUTER_LISTENER;
+    listener->distributer = distributer;
+    listener->sock = sock;
+    listener->port = port;
+    strcpy(listener->path, path != NULL ? path : "");
+    strcpy(listener->key, key);
+    listener->registered = false;
+    listener->accepted = 0;
+    listener->next = distributer->listeners;
+    distributer->listeners = listener;
+
+    // set listener pointer
+    *listenerPointer = listener;
+
     return ACTOR_SUCCESS;
 }
 
-// listen incomming connections
-actor_error_t actor_distributer_listen(actor_node_t node, actor_node_id_t* nid,
-    unsigned int port, const char* key) {
-    // check valid node
-    if (node == NULL) {
+// wait for next peer connecting to listener of port or path
+static actor_error_t actor_distributer_listen_at(actor_node_t node,
+    actor_node_id_t* nid, unsigned int port, const char* path, const char* key) {
+    // check input
+    if ((node == NULL) || (key == NULL)) {
         return ACTOR_ERROR_INVALUE;
     }
 
@@ -402,120 +3069,124 @@ actor_error_t actor_distributer_listen(actor_node_t node, actor_node_id_t* nid,
         *nid = ACTOR_INVALID_ID;
     }
 
-    // create server socket
-    int bytes_received;
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    // get distributer
+    actor_distributer_t distributer = node->distributer;
 
-    // check success
-    if (sock == -1) {
-        return ACTOR_ERROR_NETWORK;
-    }
+    // get listener
+    pthread_mutex_lock(&distributer->lock);
 
-    // set socket opts
-    int yes = 1;
-    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(int));
+    actor_distributer_listener_t listener = NULL;
+    actor_error_t error = actor_distributer_get_listener(distributer, &listener,
+        port, path, key);
 
-    // create server address struct
-    struct sockaddr_in server_addr;
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port);
-    server_addr.sin_addr.s_addr = INADDR_ANY; 
-    bzero(&(server_addr.sin_zero),8);
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        pthread_mutex_unlock(&distributer->lock);
 
-    // bind socket to address
-    if (bind(sock, (struct sockaddr *)&server_addr, sizeof(struct sockaddr)) == -1) {
-        return ACTOR_ERROR_NETWORK;
+        return error;
     }
 
-    // start listening
-    if (listen(sock, 5)) {
-        return ACTOR_ERROR_NETWORK;
+    // register new listener
+    if (!listener->registered) {
+        actor_distributer_wakeup(distributer);
     }
 
-    // accept incomming connections
-    unsigned int sin_size = sizeof(struct sockaddr_in);
-    struct sockaddr_in client_addr;
-    int connected = accept(sock, (struct sockaddr *)&client_addr, &sin_size);
+    // wait for next peer
+    if (nid != NULL) {
+        unsigned long accepted = listener->accepted;
 
-    // close socket
-    close(sock);
+        while (listener->accepted == accepted) {
+            pthread_cond_wait(&distributer->accepted_condition, &distributer->lock);
+        }
 
-    // check success
-    if (connected == -1) {
-        return ACTOR_ERROR_NETWORK;
+        *nid = listener->accepted_nids[accepted %
+            ACTOR_DISTRIBUTER_ACCEPTED_HISTORY];
     }
 
-    // set recv timeout to 10 sec
-    struct timeval tv;
-    tv.tv_sec = 10;
-    tv.tv_usec = 0;
-    setsockopt(connected, SOL_SOCKET, SO_RCVTIMEO, (struct timeval*)&tv,
-        sizeof(struct timeval));
+    pthread_mutex_unlock(&distributer->lock);
 
-    // get key
-    char remote_key[ACTOR_DISTRIBUTER_KEYLENGTH + 1];
-    if (recv(connected, &remote_key, sizeof(char) * (ACTOR_DISTRIBUTER_KEYLENGTH + 1),
-        0) != ACTOR_DISTRIBUTER_KEYLENGTH + 1) {
-        // close connection
-        close(connected);
+    return ACTOR_SUCCESS;
+}
 
-        return ACTOR_ERROR_NETWORK;
+// parse endpoint, which is a port number or a unix domain socket path with
+// prefix unix:
+static actor_error_t actor_distributer_parse_endpoint(const char* endpoint,
+    unsigned int* port, const char** path) {
+    // check input
+    if (endpoint == NULL) {
+        return ACTOR_ERROR_INVALUE;
     }
 
-    // check key
-    if (strcmp(key, remote_key) != 0) {
-        // close connection
-        close(connected);
+    // get path of unix domain socket
+    actor_size_t prefix_length = strlen(ACTOR_DISTRIBUTER_UNIX_PREFIX);
+    if (strncmp(endpoint, ACTOR_DISTRIBUTER_UNIX_PREFIX, prefix_length) == 0) {
+        *port = 0;
+        *path = &endpoint[prefix_length];
 
-        return ACTOR_ERROR_NETWORK;
+        // check path length
+        if (((*path)[0] == '\0') ||
+            (strlen(*path) >= ACTOR_DISTRIBUTER_PATH_SIZE)) {
+            return ACTOR_ERROR_INVALUE;
+        }
+
+        return ACTOR_SUCCESS;
     }
 
-    // send node id
-    if (send(connected, &node->id, sizeof(actor_node_id_t), 0) <= 0) {
-        // close connection
-        close(connected);
+    // get port
+    char* end = NULL;
+    unsigned long value = strtoul(endpoint, &end, 10);
 
-        return ACTOR_ERROR_NETWORK;
+    // check port
+    if ((endpoint[0] < '0') || (endpoint[0] > '9') || (*end != '\0') ||
+        (value > 65535)) {
+        return ACTOR_ERROR_INVALUE;
     }
 
-    // get node id
-    actor_node_id_t node_id;
-    bytes_received = recv(connected, &node_id, sizeof(actor_node_id_t), 0);
+    *port = (unsigned int)value;
+    *path = NULL;
 
-    // check success
-    if (bytes_received != sizeof(actor_node_id_t)) {
-        // close connection
-        close(connected);
+    return ACTOR_SUCCESS;
+}
 
-        return ACTOR_ERROR_NETWORK;
-    }
+// start listener, which accepts any number of peers on port
+actor_error_t actor_distributer_start_listener(actor_node_t node,
+    unsigned int port, const char* key) {
+    // listen without waiting for a peer
+    return actor_distributer_listen_at(node, NULL, port, NULL, key);
+}
 
-    if ((node_id < 0) || (node_id >= ACTOR_NODE_MAX_REMOTE_NODES) ||
-        (node->remote_nodes[node_id] != ACTOR_INVALID_ID) ||
-        (node_id == node->id)){
-        // close connection
-        close(connected);
+// wait for next peer connecting to listener of port
+actor_error_t actor_distributer_listen(actor_node_t node, actor_node_id_t* nid,
+    unsigned int port, const char* key) {
+    return actor_distributer_listen_at(node, nid, port, NULL, key);
+}
 
-        return ACTOR_ERROR_NETWORK;
-    }
+// start listener, which accepts any number of peers on endpoint
+actor_error_t actor_distributer_start_listener_endpoint(actor_node_t node,
+    const char* endpoint, const char* key) {
+    // listen without waiting for a peer
+    return actor_distributer_listen_endpoint(node, NULL, endpoint, key);
+}
 
-    // start connectors
-    actor_error_t error = actor_distributer_start_connectors(node, node_id, connected);
+// wait for next peer connecting to listener of endpoint
+actor_error_t actor_distributer_listen_endpoint(actor_node_t node,
+    actor_node_id_t* nid, const char* endpoint, const char* key) {
+    // parse endpoint
+    unsigned int port = 0;
+    const char* path = NULL;
+    actor_error_t error = actor_distributer_parse_endpoint(endpoint, &port,
+        &path);
 
     // check success
     if (error != ACTOR_SUCCESS) {
-        // close connection
-        close(connected);
+        if (nid != NULL) {
+            *nid = ACTOR_INVALID_ID;
+        }
 
         return error;
     }
 
-    // set node id
-    if (nid != NULL) {
-        *nid = node_id;
-    }
-
-    return ACTOR_SUCCESS;
+    return actor_distributer_listen_at(node, nid, port, path, key);
 }
 
 // disconnect from node
@@ -534,3 +3205,83 @@ actor_error_t actor_distributer_disconnect_from_node(actor_node_t node, actor_no
     return actor_node_send_message(node, node->id, node->remote_nodes[nid],
         ACTOR_TYPE_CHAR, "STOP", 5);
 }
+
+// configure batching of outgoing messages
+actor_error_t actor_distributer_configure_batching(actor_node_t node,
+    actor_size_t batch_size, actor_time_t flush_latency) {
+    // check input
+    if ((node == NULL) || (batch_size == 0) ||
+        (batch_size > ACTOR_DISTRIBUTER_MAX_BATCH_SIZE) || (flush_latency < 0.0)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // set batching settings, running senders apply them to their next batch
+    node->distributer_batch_size = batch_size;
+    node->distributer_flush_latency = flush_latency;
+
+    return ACTOR_SUCCESS;
+}
+
+// enable checksums of frames sent to remote nodes
+actor_error_t actor_distributer_configure_checksum(actor_node_t node,
+    bool enabled) {
+    // check input
+    if (node == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // running senders apply the setting to their next frame
+    node->distributer_checksum = enabled;
+
+    return ACTOR_SUCCESS;
+}
+
+// compress messages to remote nodes of at least threshold bytes
+actor_error_t actor_distributer_configure_compression(actor_node_t node,
+    actor_size_t threshold) {
+    // check input
+    if (node == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // running senders apply the setting to their next frame
+    node->distributer_compression_threshold = threshold;
+
+    return ACTOR_SUCCESS;
+}
+
+// limit size of messages received from remote nodes
+actor_error_t actor_distributer_configure_max_message_size(actor_node_t node,
+    actor_size_t size) {
+    // check input, sizes are passed to codecs as int
+    if ((node == NULL) || (size == 0) || (size > INT_MAX)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // the reactor applies the limit to the next received frame
+    node->distributer_max_message_size = size;
+
+    return ACTOR_SUCCESS;
+}
+
+// get distributer statistics
+actor_error_t actor_distributer_get_stats(actor_node_t node,
+    actor_distributer_stats_t stats) {
+    // check input
+    if ((node == NULL) || (stats == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // counters are only updated by the reactor
+    actor_distributer_t distributer = node->distributer;
+    stats->bytes_sent = __atomic_load_n(&distributer->stats.bytes_sent,
+        __ATOMIC_RELAXED);
+    stats->bytes_received = __atomic_load_n(&distributer->stats.bytes_received,
+        __ATOMIC_RELAXED);
+    stats->frames_compressed = __atomic_load_n(
+        &distributer->stats.frames_compressed, __ATOMIC_RELAXED);
+    stats->bytes_saved = __atomic_load_n(&distributer->stats.bytes_saved,
+        __ATOMIC_RELAXED);
+
+    return ACTOR_SUCCESS;
+}
@@ -29,6 +29,8 @@ static const char* actor_error_string_dispatch = "dispatch error";
 static const char* actor_error_string_too_many_processes = "too many processes";
 static const char* actor_error_string_network = "network error";
 static const char* actor_error_string_message_passing = "message passing error";
+static const char* actor_error_string_stale_process = "stale process id";
+static const char* actor_error_string_mailbox_full = "mailbox full";
 
 // get error string by error
 const char* actor_error_string(actor_error_t error) {
@@ -60,6 +62,12 @@ const char* actor_error_string(actor_error_t error) {
     else if (error == ACTOR_ERROR_MESSAGE_PASSING) {
         return actor_error_string_message_passing;
     }
+    else if (error == ACTOR_ERROR_STALE_PROCESS) {
+        return actor_error_string_stale_process;
+    }
+    else if (error == ACTOR_ERROR_MAILBOX_FULL) {
+        return actor_error_string_mailbox_full;
+    }
     else {
         return "invalid error";
     }
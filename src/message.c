@@ -18,11 +18,20 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <string.h>
+#include <sched.h>
+#include <time.h>
 #include "../include/actor.h"
 
 // create new message
 actor_error_t actor_message_create(actor_message_t* messagePointer,
     actor_data_type_t type, actor_message_data_t const data, actor_size_t size) {
+    return actor_message_create_pooled(NULL, messagePointer, type, data, size);
+}
+
+// create new message from pool
+actor_error_t actor_message_create_pooled(actor_message_pool_t pool,
+    actor_message_t* messagePointer, actor_data_type_t type,
+    actor_message_data_t const data, actor_size_t size) {
     // check input
     if ((messagePointer == NULL) || (type < 0) || (data == NULL)) {
         return ACTOR_ERROR_INVALUE;
@@ -31,35 +40,195 @@ actor_error_t actor_message_create(actor_message_t* messagePointer,
     // init message pointer to NULL
     *messagePointer = NULL;
 
-    // create message
-    actor_message_t message = malloc(sizeof(actor_message_s));
+    // message
+    actor_message_t message = NULL;
 
-    // check success
-    if (message == NULL) {
-        return ACTOR_ERROR_MEMORY;
+    // get message from pool
+    if ((pool != NULL) && (size <= ACTOR_MESSAGE_POOL_MAX_SIZE)) {
+        actor_error_t error = actor_message_pool_get(pool, &message, size);
+
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            return error;
+        }
+    }
+    else {
+        // check for inline payload
+        bool inline_payload = size <= ACTOR_MESSAGE_INLINE_SIZE;
+
+        // create message with payload tail
+        message = malloc(sizeof(actor_message_s) +
+            (inline_payload ? size : 0));
+
+        // check success
+        if (message == NULL) {
+            return ACTOR_ERROR_MEMORY;
+        }
+
+        // init struct
+        message->pool = NULL;
+        message->capacity = inline_payload ? size : 0;
+        message->data = NULL;
+
+        // use tail or create separate message data memory
+        if (inline_payload) {
+            message->data = message->payload;
+        }
+        else {
+            message->data = malloc(size);
+
+            // check success
+            if (message->data == NULL) {
+                // release message
+                actor_message_release(&message);
+
+                return ACTOR_ERROR_MEMORY;
+            }
+        }
     }
 
     // init struct
     message->next = NULL;
     message->destination_nid = ACTOR_INVALID_ID;
     message->destination_pid = ACTOR_INVALID_ID;
+    message->source_nid = ACTOR_INVALID_ID;
+    message->source_pid = ACTOR_INVALID_ID;
+    message->correlation_id = 0;
+    message->reply = false;
+    message->priority = type == ACTOR_TYPE_ERROR_MESSAGE ?
+        ACTOR_MESSAGE_PRIORITY_SYSTEM : ACTOR_MESSAGE_PRIORITY_NORMAL;
     message->size = size;
-    message->data = NULL;
     message->type = type;
+    message->free_function = NULL;
+    message->shared_payload = NULL;
 
-    // create message data memory
-    message->data = malloc(size);
+    // copy message data
+    memcpy(message->data, data, size);
 
-    // check success
-    if (message->data == NULL) {
-        // release message
-        actor_message_release(&message);
+    // set message pointer
+    *messagePointer = message;
 
-        return ACTOR_ERROR_MEMORY;
+    return ACTOR_SUCCESS;
+}
+
+// create new message taking ownership of data
+actor_error_t actor_message_create_owned(actor_message_pool_t pool,
+    actor_message_t* messagePointer, actor_data_type_t type,
+    actor_message_data_t data, actor_size_t size,
+    actor_message_free_function_t free_function) {
+    // check input
+    if ((messagePointer == NULL) || (type < 0) || (data == NULL) ||
+        (free_function == NULL)) {
+        return ACTOR_ERROR_INVALUE;
     }
 
-    // copy message data
-    memcpy(message->data, data, size);
+    // init message pointer to NULL
+    *messagePointer = NULL;
+
+    // message
+    actor_message_t message = NULL;
+
+    // get message header from pool
+    if (pool != NULL) {
+        actor_error_t error = actor_message_pool_get(pool, &message, 0);
+
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            return error;
+        }
+    }
+    else {
+        // create message header
+        message = malloc(sizeof(actor_message_s));
+
+        // check success
+        if (message == NULL) {
+            return ACTOR_ERROR_MEMORY;
+        }
+
+        // init struct
+        message->pool = NULL;
+        message->capacity = 0;
+    }
+
+    // init struct
+    message->next = NULL;
+    message->destination_nid = ACTOR_INVALID_ID;
+    message->destination_pid = ACTOR_INVALID_ID;
+    message->source_nid = ACTOR_INVALID_ID;
+    message->source_pid = ACTOR_INVALID_ID;
+    message->correlation_id = 0;
+    message->reply = false;
+    message->priority = type == ACTOR_TYPE_ERROR_MESSAGE ?
+        ACTOR_MESSAGE_PRIORITY_SYSTEM : ACTOR_MESSAGE_PRIORITY_NORMAL;
+    message->size = size;
+    message->data = data;
+    message->type = type;
+    message->free_function = free_function;
+    message->shared_payload = NULL;
+
+    // set message pointer
+    *messagePointer = message;
+
+    return ACTOR_SUCCESS;
+}
+
+// create new message referencing shared payload
+actor_error_t actor_message_create_shared(actor_message_pool_t pool,
+    actor_message_t* messagePointer, actor_data_type_t type,
+    actor_message_payload_t payload) {
+    // check input
+    if ((messagePointer == NULL) || (type < 0) || (payload == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // init message pointer to NULL
+    *messagePointer = NULL;
+
+    // message
+    actor_message_t message = NULL;
+
+    // get message header from pool
+    if (pool != NULL) {
+        actor_error_t error = actor_message_pool_get(pool, &message, 0);
+
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            return error;
+        }
+    }
+    else {
+        // create message header
+        message = malloc(sizeof(actor_message_s));
+
+        // check success
+        if (message == NULL) {
+            return ACTOR_ERROR_MEMORY;
+        }
+
+        // init struct
+        message->pool = NULL;
+        message->capacity = 0;
+    }
+
+    // reference payload
+    actor_message_payload_retain(payload);
+
+    // init struct
+    message->next = NULL;
+    message->destination_nid = ACTOR_INVALID_ID;
+    message->destination_pid = ACTOR_INVALID_ID;
+    message->source_nid = ACTOR_INVALID_ID;
+    message->source_pid = ACTOR_INVALID_ID;
+    message->correlation_id = 0;
+    message->reply = false;
+    message->priority = type == ACTOR_TYPE_ERROR_MESSAGE ?
+        ACTOR_MESSAGE_PRIORITY_SYSTEM : ACTOR_MESSAGE_PRIORITY_NORMAL;
+    message->size = payload->size;
+    message->data = payload->data;
+    message->type = type;
+    message->free_function = NULL;
+    message->shared_payload = payload;
 
     // set message pointer
     *messagePointer = message;
@@ -76,16 +245,467 @@ actor_error_t actor_message_release(actor_message_t* messagePointer) {
     // get message
     actor_message_t message = *messagePointer;
 
-    // free message data
-    if (message->data != NULL) {
+    // set message pointer to NULL
+    *messagePointer = NULL;
+
+    // release owned message data
+    if (message->free_function != NULL) {
+        message->free_function(message->data);
+        message->data = NULL;
+    }
+
+    // release shared payload
+    if (message->shared_payload != NULL) {
+        actor_message_payload_release(&message->shared_payload);
+        message->data = NULL;
+    }
+
+    // return message to pool
+    if (message->pool != NULL) {
+        return actor_message_pool_put(message);
+    }
+
+    // free separate message data
+    if ((message->data != NULL) && (message->data != message->payload)) {
         free(message->data);
     }
 
     // free memory
     free(message);
 
-    // set message pointer to NULL
-    *messagePointer = NULL;
+    return ACTOR_SUCCESS;
+}
+
+// create shared payload with copy of data
+actor_error_t actor_message_payload_create(actor_message_payload_t* payloadPointer,
+    actor_message_data_t const data, actor_size_t size) {
+    // check input
+    if ((payloadPointer == NULL) || (data == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // init payload pointer to NULL
+    *payloadPointer = NULL;
+
+    // create payload with data tail
+    actor_message_payload_t payload = malloc(sizeof(actor_message_payload_s) +
+        size);
+
+    // check success
+    if (payload == NULL) {
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // init struct
+    payload->reference_count = 1;
+    payload->size = size;
+
+    // copy data
+    memcpy(payload->data, data, size);
+
+    // set payload pointer
+    *payloadPointer = payload;
+
+    return ACTOR_SUCCESS;
+}
+
+// retain shared payload
+actor_error_t actor_message_payload_retain(actor_message_payload_t payload) {
+    // check input
+    if (payload == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // increment reference count
+    __atomic_add_fetch(&payload->reference_count, 1, __ATOMIC_RELAXED);
+
+    return ACTOR_SUCCESS;
+}
+
+// release shared payload
+actor_error_t actor_message_payload_release(actor_message_payload_t* payloadPointer) {
+    // check for valid payload
+    if ((payloadPointer == NULL) || (*payloadPointer == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // get payload
+    actor_message_payload_t payload = *payloadPointer;
+
+    // set payload pointer to NULL
+    *payloadPointer = NULL;
+
+    // free memory with last reference
+    if (__atomic_sub_fetch(&payload->reference_count, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(payload);
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// push message to lane, lock free for any number of producers
+static void actor_message_queue_lane_push(actor_message_queue_lane_t lane,
+    actor_message_t message) {
+    // message becomes new end of lane
+    message->next = NULL;
+
+    // swap message in as last element
+    actor_message_t previous = __atomic_exchange_n(&lane->last, message,
+        __ATOMIC_SEQ_CST);
+
+    // link previous last element to message
+    __atomic_store_n(&previous->next, (struct actor_message_s*)message,
+        __ATOMIC_RELEASE);
+}
+
+// pop message from lane, only called by consumer or with pop lock held
+static actor_message_t actor_message_queue_lane_pop(
+    actor_message_queue_lane_t lane) {
+    // get first message and its successor
+    actor_message_t first = lane->first;
+    actor_message_t next = (actor_message_t)__atomic_load_n(&first->next,
+        __ATOMIC_ACQUIRE);
+
+    // skip stub message
+    if (first == lane->stub) {
+        // check for empty lane
+        if (next == NULL) {
+            return NULL;
+        }
+
+        lane->first = next;
+        first = next;
+        next = (actor_message_t)__atomic_load_n(&first->next, __ATOMIC_ACQUIRE);
+    }
+
+    // check for following message
+    if (next != NULL) {
+        lane->first = next;
+        first->next = NULL;
+
+        return first;
+    }
+
+    // a producer is in the middle of a push
+    if (first != __atomic_load_n(&lane->last, __ATOMIC_SEQ_CST)) {
+        return NULL;
+    }
+
+    // reinsert stub to be able to detach the last message
+    actor_message_queue_lane_push(lane, lane->stub);
+
+    // check for following message
+    next = (actor_message_t)__atomic_load_n(&first->next, __ATOMIC_ACQUIRE);
+    if (next != NULL) {
+        lane->first = next;
+        first->next = NULL;
+
+        return first;
+    }
+
+    return NULL;
+}
+
+// check lane for pushed messages, only called by consumer or with pop lock
+// held
+static bool actor_message_queue_lane_pending(actor_message_queue_lane_t lane) {
+    return (lane->first != lane->stub) ||
+        (__atomic_load_n(&lane->stub->next, __ATOMIC_ACQUIRE) != NULL) ||
+        (__atomic_load_n(&lane->last, __ATOMIC_SEQ_CST) != lane->stub);
+}
+
+// serialise pops of normal lane, if producers drop the oldest message
+static void actor_message_queue_lock(actor_message_queue_t queue) {
+    if (queue->policy != ACTOR_MESSAGE_QUEUE_DROP_OLDEST) {
+        return;
+    }
+
+    while (__atomic_exchange_n(&queue->pop_lock, 1, __ATOMIC_ACQUIRE) != 0) {
+        sched_yield();
+    }
+}
+
+// release pop lock
+static void actor_message_queue_unlock(actor_message_queue_t queue) {
+    if (queue->policy != ACTOR_MESSAGE_QUEUE_DROP_OLDEST) {
+        return;
+    }
+
+    __atomic_store_n(&queue->pop_lock, 0, __ATOMIC_RELEASE);
+}
+
+// pop message from lanes above normal priority, only called by consumer
+static actor_message_t actor_message_queue_pop_system(
+    actor_message_queue_t queue) {
+    for (int priority = ACTOR_MESSAGE_QUEUE_LANE_COUNT - 1;
+        priority > ACTOR_MESSAGE_PRIORITY_NORMAL; priority--) {
+        actor_message_t message = actor_message_queue_lane_pop(
+            &queue->lanes[priority]);
+
+        if (message != NULL) {
+            return message;
+        }
+    }
+
+    return NULL;
+}
+
+// pop message from normal lane
+static actor_message_t actor_message_queue_pop_normal(
+    actor_message_queue_t queue) {
+    actor_message_queue_lock(queue);
+    actor_message_t message = actor_message_queue_lane_pop(
+        &queue->lanes[ACTOR_MESSAGE_PRIORITY_NORMAL]);
+    actor_message_queue_unlock(queue);
+
+    return message;
+}
+
+// pop message from lane of priority, only called by consumer
+static actor_message_t actor_message_queue_pop_lane(actor_message_queue_t queue,
+    int priority) {
+    if (priority == ACTOR_MESSAGE_PRIORITY_NORMAL) {
+        return actor_message_queue_pop_normal(queue);
+    }
+
+    return actor_message_queue_lane_pop(&queue->lanes[priority]);
+}
+
+// pop message of highest priority, only called by consumer
+static actor_message_t actor_message_queue_pop(actor_message_queue_t queue) {
+    actor_message_t message = actor_message_queue_pop_system(queue);
+
+    if (message == NULL) {
+        message = actor_message_queue_pop_normal(queue);
+    }
+
+    return message;
+}
+
+// check normal lane for pushed messages
+static bool actor_message_queue_normal_pending(actor_message_queue_t queue) {
+    actor_message_queue_lock(queue);
+    bool pending = actor_message_queue_lane_pending(
+        &queue->lanes[ACTOR_MESSAGE_PRIORITY_NORMAL]);
+    actor_message_queue_unlock(queue);
+
+    return pending;
+}
+
+// check for pushed messages, only called by consumer
+static bool actor_message_queue_pending(actor_message_queue_t queue) {
+    for (int priority = ACTOR_MESSAGE_QUEUE_LANE_COUNT - 1;
+        priority > ACTOR_MESSAGE_PRIORITY_NORMAL; priority--) {
+        if (actor_message_queue_lane_pending(&queue->lanes[priority])) {
+            return true;
+        }
+    }
+
+    return actor_message_queue_normal_pending(queue);
+}
+
+// lock waiter list of parked producers
+static void actor_message_queue_space_lock(actor_message_queue_t queue) {
+    while (__atomic_exchange_n(&queue->space_lock, 1, __ATOMIC_ACQUIRE) != 0) {
+        sched_yield();
+    }
+}
+
+// release lock of waiter list
+static void actor_message_queue_space_unlock(actor_message_queue_t queue) {
+    __atomic_store_n(&queue->space_lock, 0, __ATOMIC_RELEASE);
+}
+
+// unpark first parked producer, all of them for a released queue
+static void actor_message_queue_unpark_producers(actor_message_queue_t queue,
+    bool all) {
+    do {
+        // take waiter, which is not touched after the lock is released
+        actor_message_queue_space_lock(queue);
+        actor_message_queue_waiter_t waiter = queue->space_first;
+        actor_scheduler_task_t task = NULL;
+        if (waiter != NULL) {
+            __atomic_store_n(&queue->space_first, waiter->next,
+                __ATOMIC_SEQ_CST);
+            if (queue->space_first == NULL) {
+                queue->space_last = NULL;
+            }
+            waiter->woken = true;
+            task = waiter->task;
+        }
+        actor_message_queue_space_unlock(queue);
+
+        if (task == NULL) {
+            return;
+        }
+
+        actor_scheduler_task_unpark(task);
+    } while (all);
+}
+
+// call space notification of producer, which found the queue full
+static void actor_message_queue_space_notify(actor_message_queue_t queue) {
+    if (__atomic_load_n(&queue->space_notify_function, __ATOMIC_SEQ_CST) ==
+        NULL) {
+        return;
+    }
+
+    // only one caller takes the notification
+    actor_message_queue_notify_function_t function = __atomic_exchange_n(
+        &queue->space_notify_function, NULL, __ATOMIC_SEQ_CST);
+    if (function != NULL) {
+        function(__atomic_load_n(&queue->space_notify_context,
+            __ATOMIC_SEQ_CST));
+    }
+}
+
+// give space of message taken by consumer free for producers
+static void actor_message_queue_taken(actor_message_queue_t queue,
+    actor_message_t message) {
+    // unbounded queues and system messages are not counted
+    if ((queue->capacity == 0) ||
+        (message->priority != ACTOR_MESSAGE_PRIORITY_NORMAL)) {
+        return;
+    }
+
+    __atomic_sub_fetch(&queue->count, 1, __ATOMIC_SEQ_CST);
+
+    // wake up a blocked and a parked producer, which check the count again,
+    // and notify a producer, which retries later
+    if (__atomic_load_n(&queue->space_waiting, __ATOMIC_SEQ_CST) > 0) {
+        dispatch_semaphore_signal(queue->semaphore_space);
+    }
+    if (__atomic_load_n(&queue->space_first, __ATOMIC_SEQ_CST) != NULL) {
+        actor_message_queue_unpark_producers(queue, false);
+    }
+    actor_message_queue_space_notify(queue);
+}
+
+// check for empty queue including save lists, only called by consumer
+static bool actor_message_queue_empty(actor_message_queue_t queue) {
+    for (int priority = 0; priority < ACTOR_MESSAGE_QUEUE_LANE_COUNT;
+        priority++) {
+        if (queue->saved_first[priority] != NULL) {
+            return false;
+        }
+    }
+
+    return !actor_message_queue_pending(queue);
+}
+
+// append message to save list of its lane, only called by consumer
+static void actor_message_queue_save(actor_message_queue_t queue,
+    actor_message_t message) {
+    int priority = message->priority;
+    message->next = NULL;
+
+    if (queue->saved_last[priority] == NULL) {
+        queue->saved_first[priority] = message;
+    }
+    else {
+        queue->saved_last[priority]->next = (struct actor_message_s*)message;
+    }
+    queue->saved_last[priority] = message;
+}
+
+// take oldest message of save list of priority, only called by consumer
+static actor_message_t actor_message_queue_unsave(actor_message_queue_t queue,
+    int priority) {
+    actor_message_t message = queue->saved_first[priority];
+
+    if (message != NULL) {
+        queue->saved_first[priority] = (actor_message_t)message->next;
+        if (queue->saved_first[priority] == NULL) {
+            queue->saved_last[priority] = NULL;
+        }
+        message->next = NULL;
+    }
+
+    return message;
+}
+
+// drop oldest saved messages of queue exceeding its capacity, which
+// producers cannot drop, only called by consumer
+static void actor_message_queue_drop_saved(actor_message_queue_t queue) {
+    if ((queue->capacity == 0) ||
+        (queue->policy != ACTOR_MESSAGE_QUEUE_DROP_OLDEST)) {
+        return;
+    }
+
+    while ((__atomic_load_n(&queue->count, __ATOMIC_SEQ_CST) >
+        (long)queue->capacity) &&
+        (queue->saved_first[ACTOR_MESSAGE_PRIORITY_NORMAL] != NULL)) {
+        actor_message_t message = actor_message_queue_unsave(queue,
+            ACTOR_MESSAGE_PRIORITY_NORMAL);
+
+        // release message
+        __atomic_sub_fetch(&queue->count, 1, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&queue->dropped, 1, __ATOMIC_RELAXED);
+        actor_message_release(&message);
+    }
+}
+
+// take next message without waiting, system messages come first, saved
+// messages are older than the ones of their lane, only called by consumer
+static actor_message_t actor_message_queue_next(actor_message_queue_t queue) {
+    actor_message_t message = NULL;
+
+    for (int priority = ACTOR_MESSAGE_QUEUE_LANE_COUNT - 1;
+        (message == NULL) && (priority >= ACTOR_MESSAGE_PRIORITY_NORMAL);
+        priority--) {
+        message = actor_message_queue_unsave(queue, priority);
+
+        if (message == NULL) {
+            message = actor_message_queue_pop_lane(queue, priority);
+        }
+    }
+    if (message != NULL) {
+        actor_message_queue_taken(queue, message);
+    }
+
+    return message;
+}
+
+// current time in seconds
+static actor_time_t actor_message_queue_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (actor_time_t)now.tv_sec + (actor_time_t)now.tv_nsec /
+        (actor_time_t)NSEC_PER_SEC;
+}
+
+// wake up waiting consumer
+static void actor_message_queue_signal(actor_message_queue_t queue) {
+    if (queue->notify_function != NULL) {
+        queue->notify_function(queue->notify_context);
+    }
+    else if (queue->task != NULL) {
+        actor_scheduler_task_unpark(queue->task);
+    }
+    else {
+        dispatch_semaphore_signal(queue->semaphore_messages);
+    }
+}
+
+// wait for signal of producer
+static actor_error_t actor_message_queue_wait(actor_message_queue_t queue,
+    actor_time_t timeout) {
+    // park green task
+    if (queue->task != NULL) {
+        return actor_scheduler_task_park(queue->task, timeout);
+    }
+
+    // wait on semaphore
+    dispatch_time_t deadline = DISPATCH_TIME_FOREVER;
+    if (timeout != ACTOR_SCHEDULER_FOREVER) {
+        deadline = dispatch_time(DISPATCH_TIME_NOW,
+            (dispatch_time_t)(timeout * (actor_time_t)NSEC_PER_SEC));
+    }
+
+    if (dispatch_semaphore_wait(queue->semaphore_messages, deadline) != 0) {
+        return ACTOR_ERROR_TIMEOUT;
+    }
 
     return ACTOR_SUCCESS;
 }
@@ -109,18 +729,72 @@ actor_error_t actor_message_queue_create(actor_message_queue_t* queuePointer) {
     }
 
     // init struct
-    queue->semaphore_read_write = NULL;
+    for (int priority = 0; priority < ACTOR_MESSAGE_QUEUE_LANE_COUNT;
+        priority++) {
+        queue->lanes[priority].first = NULL;
+        queue->lanes[priority].last = NULL;
+        queue->lanes[priority].stub = NULL;
+        queue->saved_first[priority] = NULL;
+        queue->saved_last[priority] = NULL;
+    }
+    queue->waiting = 0;
     queue->semaphore_messages = NULL;
-    queue->first = NULL;
-    queue->last = NULL;
+    queue->task = NULL;
+    queue->notify_function = NULL;
+    queue->notify_context = NULL;
+    queue->space_notify_function = NULL;
+    queue->space_notify_context = NULL;
+    queue->count = 0;
+    queue->capacity = 0;
+    queue->policy = ACTOR_MESSAGE_QUEUE_BLOCK;
+    queue->block_timeout = 0.0;
+    queue->space_waiting = 0;
+    queue->semaphore_space = NULL;
+    queue->space_first = NULL;
+    queue->space_last = NULL;
+    queue->space_parked = 0;
+    queue->space_lock = 0;
+    queue->pop_lock = 0;
+    queue->pushing = 0;
+    queue->closed = 0;
+    queue->dropped = 0;
 
-    // create semaphores
-    queue->semaphore_read_write = dispatch_semaphore_create(1);
+    // create stub message of each lane
+    for (int priority = 0; priority < ACTOR_MESSAGE_QUEUE_LANE_COUNT;
+        priority++) {
+        actor_message_queue_lane_t lane = &queue->lanes[priority];
+        lane->stub = malloc(sizeof(actor_message_s));
+
+        // check success
+        if (lane->stub == NULL) {
+            // release message queue
+            actor_message_queue_release(&queue);
+
+            return ACTOR_ERROR_MEMORY;
+        }
+
+        // init lane with stub
+        lane->stub->next = NULL;
+        lane->first = lane->stub;
+        lane->last = lane->stub;
+    }
+
+    // create semaphore
     queue->semaphore_messages = dispatch_semaphore_create(0);
 
     // check success
-    if ((queue->semaphore_read_write == NULL) ||
-        (queue->semaphore_messages == NULL)) {
+    if (queue->semaphore_messages == NULL) {
+        // release message queue
+        actor_message_queue_release(&queue);
+
+        return ACTOR_ERROR_DISPATCH;
+    }
+
+    // create space semaphore
+    queue->semaphore_space = dispatch_semaphore_create(0);
+
+    // check success
+    if (queue->semaphore_space == NULL) {
         // release message queue
         actor_message_queue_release(&queue);
 
@@ -133,6 +807,32 @@ actor_error_t actor_message_queue_create(actor_message_queue_t* queuePointer) {
     return ACTOR_SUCCESS;
 }
 
+actor_error_t actor_message_queue_close(actor_message_queue_t queue) {
+    // check for valid queue
+    if (queue == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // refuse further messages
+    __atomic_store_n(&queue->closed, 1, __ATOMIC_SEQ_CST);
+
+    // send blocked and parked producers away, later ones see the flag
+    long waiting = __atomic_load_n(&queue->space_waiting, __ATOMIC_SEQ_CST);
+    for (long i = 0; i < waiting; i++) {
+        dispatch_semaphore_signal(queue->semaphore_space);
+    }
+    actor_message_queue_unpark_producers(queue, true);
+    actor_message_queue_space_notify(queue);
+
+    // wait for producers pushing right now, which may still notify the
+    // consumer, pushes do not block
+    while (__atomic_load_n(&queue->pushing, __ATOMIC_SEQ_CST) != 0) {
+        sched_yield();
+    }
+
+    return ACTOR_SUCCESS;
+}
+
 actor_error_t actor_message_queue_release(actor_message_queue_t* queuePointer) {
     // check for valid queue
     if ((queuePointer == NULL) || (*queuePointer == NULL)) {
@@ -142,24 +842,44 @@ actor_error_t actor_message_queue_release(actor_message_queue_t* queuePointer) {
     // get queue
     actor_message_queue_t queue = *queuePointer;
 
+    // send blocked and parked producers away and wait for them
+    if (queue->semaphore_space != NULL) {
+        actor_message_queue_close(queue);
+        while ((__atomic_load_n(&queue->space_waiting, __ATOMIC_SEQ_CST) != 0) ||
+            (__atomic_load_n(&queue->space_parked, __ATOMIC_SEQ_CST) != 0)) {
+            dispatch_semaphore_signal(queue->semaphore_space);
+            actor_message_queue_unpark_producers(queue, true);
+            sched_yield();
+        }
+    }
+
     // release all messages
-    actor_message_t message = NULL;
-    do {
-        // get message
-        actor_message_queue_get(queue, &message, 0.0);
+    for (int priority = 0; priority < ACTOR_MESSAGE_QUEUE_LANE_COUNT;
+        priority++) {
+        actor_message_t message = NULL;
+        while ((message = actor_message_queue_unsave(queue, priority)) != NULL) {
+            actor_message_release(&message);
+        }
 
-        // release message
-        actor_message_release(&message);
-    } while (message != NULL);
+        actor_message_queue_lane_t lane = &queue->lanes[priority];
+        if (lane->stub == NULL) {
+            continue;
+        }
+
+        while ((message = actor_message_queue_lane_pop(lane)) != NULL) {
+            actor_message_release(&message);
+        }
 
-    // release semaphores
-    if (queue->semaphore_read_write != NULL) {
-        dispatch_release(queue->semaphore_read_write);
+        free(lane->stub);
     }
 
+    // release semaphore
     if (queue->semaphore_messages != NULL) {
         dispatch_release(queue->semaphore_messages);
     }
+    if (queue->semaphore_space != NULL) {
+        dispatch_release(queue->semaphore_space);
+    }
 
     // free queue
     free(queue);
@@ -170,36 +890,314 @@ actor_error_t actor_message_queue_release(actor_message_queue_t* queuePointer) {
     return ACTOR_SUCCESS;
 }
 
+// limit queue to capacity messages
+actor_error_t actor_message_queue_set_capacity(actor_message_queue_t queue,
+    actor_size_t capacity, actor_message_queue_policy_t policy,
+    actor_time_t timeout) {
+    // check for correct input
+    if ((queue == NULL) || (policy < ACTOR_MESSAGE_QUEUE_BLOCK) ||
+        (policy > ACTOR_MESSAGE_QUEUE_DROP_NEWEST) ||
+        ((timeout < 0.0) && (timeout != ACTOR_SCHEDULER_FOREVER))) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // set limit
+    queue->capacity = capacity;
+    queue->policy = capacity != 0 ? policy : ACTOR_MESSAGE_QUEUE_BLOCK;
+    queue->block_timeout = timeout;
+
+    return ACTOR_SUCCESS;
+}
+
+// block producer thread until a message is taken or timeout expires
+static actor_error_t actor_message_queue_block_producer(
+    actor_message_queue_t queue, actor_time_t timeout) {
+    // announce waiting producer and recheck count to not miss a message
+    // taken before announcement
+    __atomic_add_fetch(&queue->space_waiting, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&queue->count, __ATOMIC_SEQ_CST) <
+        (long)queue->capacity) {
+        __atomic_sub_fetch(&queue->space_waiting, 1, __ATOMIC_SEQ_CST);
+
+        return ACTOR_SUCCESS;
+    }
+
+    // a closing queue might not have seen the announcement
+    if (__atomic_load_n(&queue->closed, __ATOMIC_SEQ_CST) != 0) {
+        __atomic_sub_fetch(&queue->space_waiting, 1, __ATOMIC_SEQ_CST);
+
+        return ACTOR_ERROR_STALE_PROCESS;
+    }
+
+    // wait for consumer
+    dispatch_time_t deadline = DISPATCH_TIME_FOREVER;
+    if (timeout != ACTOR_SCHEDULER_FOREVER) {
+        deadline = dispatch_time(DISPATCH_TIME_NOW,
+            (dispatch_time_t)(timeout * (actor_time_t)NSEC_PER_SEC));
+    }
+    dispatch_semaphore_wait(queue->semaphore_space, deadline);
+
+    // the queue is freed after the last producer is gone
+    bool closed = __atomic_load_n(&queue->closed, __ATOMIC_SEQ_CST) != 0;
+    __atomic_sub_fetch(&queue->space_waiting, 1, __ATOMIC_SEQ_CST);
+
+    return closed ? ACTOR_ERROR_STALE_PROCESS : ACTOR_SUCCESS;
+}
+
+// park producer task until a message is taken or timeout expires, so that
+// its worker runs other tasks meanwhile
+static actor_error_t actor_message_queue_park_producer(
+    actor_message_queue_t queue, actor_scheduler_task_t task,
+    actor_time_t timeout) {
+    // register waiter and recheck count to not miss a message taken before
+    // registration
+    actor_message_queue_waiter_s waiter;
+    waiter.next = NULL;
+    waiter.task = task;
+    waiter.woken = false;
+    __atomic_add_fetch(&queue->space_parked, 1, __ATOMIC_SEQ_CST);
+
+    actor_message_queue_space_lock(queue);
+    if (queue->space_last == NULL) {
+        __atomic_store_n(&queue->space_first, &waiter, __ATOMIC_SEQ_CST);
+    }
+    else {
+        queue->space_last->next = &waiter;
+    }
+    queue->space_last = &waiter;
+    actor_message_queue_space_unlock(queue);
+
+    // a closing queue might have unparked its waiters before registration
+    bool notified = false;
+    if ((__atomic_load_n(&queue->count, __ATOMIC_SEQ_CST) >=
+        (long)queue->capacity) &&
+        (__atomic_load_n(&queue->closed, __ATOMIC_SEQ_CST) == 0)) {
+        notified = actor_scheduler_task_park(task, timeout) == ACTOR_SUCCESS;
+    }
+
+    // unregister waiter, unless a consumer took it and is about to unpark
+    // the task
+    actor_message_queue_space_lock(queue);
+    bool woken = waiter.woken;
+    if (!woken) {
+        actor_message_queue_waiter_t previous = NULL;
+        actor_message_queue_waiter_t current = queue->space_first;
+        while (current != &waiter) {
+            previous = current;
+            current = current->next;
+        }
+
+        if (previous == NULL) {
+            __atomic_store_n(&queue->space_first, waiter.next, __ATOMIC_SEQ_CST);
+        }
+        else {
+            previous->next = waiter.next;
+        }
+        if (queue->space_last == &waiter) {
+            queue->space_last = previous;
+        }
+    }
+    actor_message_queue_space_unlock(queue);
+
+    // consume pending unpark, which must not wake a later park of the task
+    if (woken && !notified) {
+        actor_scheduler_task_park(task, ACTOR_SCHEDULER_FOREVER);
+    }
+
+    // the queue is freed after the last producer is gone
+    bool closed = __atomic_load_n(&queue->closed, __ATOMIC_SEQ_CST) != 0;
+    __atomic_sub_fetch(&queue->space_parked, 1, __ATOMIC_SEQ_CST);
+
+    return closed ? ACTOR_ERROR_STALE_PROCESS : ACTOR_SUCCESS;
+}
+
+// reserve space for one message, waits at most timeout for a full queue
+static actor_error_t actor_message_queue_reserve(actor_message_queue_t queue,
+    actor_time_t timeout) {
+    // unbounded queues do not count messages
+    if (queue->capacity == 0) {
+        return ACTOR_SUCCESS;
+    }
+
+    // green tasks park instead of blocking their worker, jobs running on a
+    // worker must not wait at all
+    actor_scheduler_task_t task = NULL;
+    bool worker = false;
+    actor_scheduler_current_task(&task, &worker);
+    if (worker && (task == NULL)) {
+        timeout = 0.0;
+    }
+
+    // deadline of blocking policy
+    actor_time_t deadline = 0.0;
+    if ((timeout != ACTOR_SCHEDULER_FOREVER) && (timeout != 0.0)) {
+        deadline = actor_message_queue_now() + timeout;
+    }
+
+    while (true) {
+        // take slot optimistically
+        if (__atomic_add_fetch(&queue->count, 1, __ATOMIC_SEQ_CST) <=
+            (long)queue->capacity) {
+            return ACTOR_SUCCESS;
+        }
+        __atomic_sub_fetch(&queue->count, 1, __ATOMIC_SEQ_CST);
+
+        // check for blocking policy
+        if ((queue->policy != ACTOR_MESSAGE_QUEUE_BLOCK) || (timeout == 0.0)) {
+            return ACTOR_ERROR_MAILBOX_FULL;
+        }
+
+        // wait for consumer with remaining time, a wakeup does not
+        // guarantee a slot
+        actor_time_t remaining = ACTOR_SCHEDULER_FOREVER;
+        if (timeout != ACTOR_SCHEDULER_FOREVER) {
+            remaining = deadline - actor_message_queue_now();
+
+            if (remaining <= 0.0) {
+                return ACTOR_ERROR_MAILBOX_FULL;
+            }
+        }
+
+        actor_error_t error = task != NULL ?
+            actor_message_queue_park_producer(queue, task, remaining) :
+            actor_message_queue_block_producer(queue, remaining);
+        if (error != ACTOR_SUCCESS) {
+            return error;
+        }
+    }
+}
+
+// drop oldest messages of queue exceeding its capacity
+static void actor_message_queue_drop_oldest(actor_message_queue_t queue) {
+    while (__atomic_load_n(&queue->count, __ATOMIC_SEQ_CST) >
+        (long)queue->capacity) {
+        actor_message_t message = actor_message_queue_pop_normal(queue);
+
+        // a producer is linking a message, which is available in a moment
+        if ((message == NULL) && actor_message_queue_normal_pending(queue)) {
+            sched_yield();
+
+            continue;
+        }
+
+        // remaining messages are saved ones, which are private to the
+        // consumer
+        if (message == NULL) {
+            return;
+        }
+
+        // release message
+        __atomic_sub_fetch(&queue->count, 1, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&queue->dropped, 1, __ATOMIC_RELAXED);
+        actor_message_release(&message);
+    }
+}
+
+// add new message to queue, waiting at most timeout for space
+static actor_error_t actor_message_queue_put_message(
+    actor_message_queue_t queue, actor_message_t message,
+    actor_time_t timeout) {
+    // check for correct input
+    if ((queue == NULL) || (message == NULL) ||
+        (message->priority < ACTOR_MESSAGE_PRIORITY_NORMAL) ||
+        (message->priority >= ACTOR_MESSAGE_QUEUE_LANE_COUNT)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // make room for message, system messages always get through
+    bool counted = message->priority == ACTOR_MESSAGE_PRIORITY_NORMAL;
+    if (counted && (queue->policy == ACTOR_MESSAGE_QUEUE_DROP_OLDEST)) {
+        __atomic_add_fetch(&queue->count, 1, __ATOMIC_SEQ_CST);
+        actor_message_queue_drop_oldest(queue);
+    }
+    else if (counted) {
+        actor_error_t error = actor_message_queue_reserve(queue, timeout);
+
+        // the newest message is dropped silently
+        if ((error == ACTOR_ERROR_MAILBOX_FULL) &&
+            (queue->policy == ACTOR_MESSAGE_QUEUE_DROP_NEWEST)) {
+            __atomic_add_fetch(&queue->dropped, 1, __ATOMIC_RELAXED);
+            actor_message_release(&message);
+
+            return ACTOR_SUCCESS;
+        }
+        else if (error != ACTOR_SUCCESS) {
+            return error;
+        }
+    }
+
+    // announce push, so that closing the queue waits for the consumer to
+    // be notified, a closed queue takes no more messages
+    __atomic_add_fetch(&queue->pushing, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&queue->closed, __ATOMIC_SEQ_CST) != 0) {
+        __atomic_sub_fetch(&queue->pushing, 1, __ATOMIC_SEQ_CST);
+
+        return ACTOR_ERROR_STALE_PROCESS;
+    }
+
+    // enqueue message to lane of its priority
+    actor_message_queue_lane_push(&queue->lanes[message->priority], message);
+
+    // wake up consumer, if it waits for messages
+    if ((__atomic_load_n(&queue->waiting, __ATOMIC_SEQ_CST) != 0) &&
+        (__atomic_exchange_n(&queue->waiting, 0, __ATOMIC_SEQ_CST) != 0)) {
+        actor_message_queue_signal(queue);
+    }
+
+    __atomic_sub_fetch(&queue->pushing, 1, __ATOMIC_SEQ_CST);
+
+    return ACTOR_SUCCESS;
+}
+
 // add new message to queue
 actor_error_t actor_message_queue_put(actor_message_queue_t queue,
     actor_message_t message) {
     // check for correct input
-    if ((queue == NULL) || (message == NULL)) {
+    if (queue == NULL) {
         return ACTOR_ERROR_INVALUE;
     }
 
-    // get write access
-    dispatch_semaphore_wait(queue->semaphore_read_write, DISPATCH_TIME_FOREVER);
+    return actor_message_queue_put_message(queue, message,
+        queue->block_timeout);
+}
 
-    // check if first message is NULL
-    if (queue->first == NULL) {
-        // set new message as first and last
-        queue->first = message;
-        queue->last = message;
-        message->next = NULL;
+// add new message to queue without waiting for space
+actor_error_t actor_message_queue_try_put(actor_message_queue_t queue,
+    actor_message_t message) {
+    return actor_message_queue_put_message(queue, message, 0.0);
+}
+
+// wait for next message pushed to empty queue, only called by consumer
+static actor_error_t actor_message_queue_wait_message(
+    actor_message_queue_t queue, actor_time_t timeout) {
+    // check for non blocking call
+    if (timeout == 0.0) {
+        return ACTOR_ERROR_TIMEOUT;
     }
-    else {
-        // set new message as last
-        queue->last->next = (struct actor_message_s*)message;
-        queue->last = message;
-        message->next = NULL;
+
+    // announce waiting consumer
+    __atomic_store_n(&queue->waiting, 1, __ATOMIC_SEQ_CST);
+
+    // recheck queue to not miss a message pushed before announcement
+    if (actor_message_queue_pending(queue)) {
+        // revoke announcement, consume signal of producer which took it
+        if (__atomic_exchange_n(&queue->waiting, 0, __ATOMIC_SEQ_CST) == 0) {
+            actor_message_queue_wait(queue, ACTOR_SCHEDULER_FOREVER);
+        }
+
+        return ACTOR_SUCCESS;
     }
 
-    // signal new message
-    dispatch_semaphore_signal(queue->semaphore_messages);
+    // wait for producer, a signal guarantees a message
+    if (actor_message_queue_wait(queue, timeout) != ACTOR_SUCCESS) {
+        // revoke announcement, if no producer took it in the meantime
+        if (__atomic_exchange_n(&queue->waiting, 0, __ATOMIC_SEQ_CST) != 0) {
+            return ACTOR_ERROR_TIMEOUT;
+        }
 
-    // signal read write access
-    dispatch_semaphore_signal(queue->semaphore_read_write);
+        // consume signal of producer
+        actor_message_queue_wait(queue, ACTOR_SCHEDULER_FOREVER);
+    }
 
     return ACTOR_SUCCESS;
 }
@@ -215,46 +1213,213 @@ actor_error_t actor_message_queue_get(actor_message_queue_t queue,
     // init message pointer to NULL;
     *message = NULL;
 
-    // get message recource
-    long err = dispatch_semaphore_wait(queue->semaphore_messages,
-        dispatch_time(DISPATCH_TIME_NOW,
-            (dispatch_time_t)(timeout * (actor_time_t)NSEC_PER_SEC)));
+    // get message
+    while (true) {
+        // try to get message without any synchronisation
+        actor_message_t newMessage = actor_message_queue_next(queue);
 
-    // check for timeout
-    if (err != 0) {
-        return ACTOR_ERROR_TIMEOUT;
+        // check success
+        if (newMessage != NULL) {
+            *message = newMessage;
+
+            return ACTOR_SUCCESS;
+        }
+
+        // a producer is linking a message, which is available in a moment
+        if (actor_message_queue_pending(queue)) {
+            sched_yield();
+
+            continue;
+        }
+
+        // wait for producer, a signal guarantees a message and timeout is
+        // hence only waited once
+        if (actor_message_queue_wait_message(queue, timeout) != ACTOR_SUCCESS) {
+            return ACTOR_ERROR_TIMEOUT;
+        }
+    }
+}
+
+// get up to max messages
+actor_error_t actor_message_queue_get_batch(actor_message_queue_t queue,
+    actor_message_t* messages, actor_size_t max, actor_size_t* count,
+    actor_time_t timeout) {
+    // check for correct input
+    if ((queue == NULL) || (messages == NULL) || (max == 0) ||
+        (count == NULL) || (timeout < 0.0)) {
+        return ACTOR_ERROR_INVALUE;
     }
 
-    // get read acces
-    dispatch_semaphore_wait(queue->semaphore_read_write, DISPATCH_TIME_FOREVER);
+    // init count
+    *count = 0;
 
-    // get message
-    actor_message_t newMessage = queue->first;
+    // wait for first message
+    actor_error_t error = actor_message_queue_get(queue, &messages[0], timeout);
+
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        return error;
+    }
+    *count = 1;
 
-    // check message
-    if (newMessage == NULL) {
-        // signal read write access
-        dispatch_semaphore_signal(queue->semaphore_read_write);
+    // take available messages in the order of single gets, a message in
+    // the middle of a push is left for the next call
+    while (*count < max) {
+        actor_message_t message = actor_message_queue_next(queue);
 
-        return ACTOR_ERROR_MESSAGE_PASSING;
+        if (message == NULL) {
+            break;
+        }
+
+        messages[(*count)++] = message;
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// get first message matching predicate
+actor_error_t actor_message_queue_get_match(actor_message_queue_t queue,
+    actor_message_t* message, actor_message_predicate_t predicate,
+    actor_time_t timeout) {
+    // check for correct input
+    if ((queue == NULL) || (timeout < 0.0) || (message == NULL) ||
+        (predicate == NULL)) {
+        return ACTOR_ERROR_INVALUE;
     }
 
-    // set new first message to next
-    queue->first = (actor_message_t)newMessage->next;
+    // init message pointer to NULL;
+    *message = NULL;
+
+    // scan messages skipped by earlier selective gets, system ones first
+    for (int priority = ACTOR_MESSAGE_QUEUE_LANE_COUNT - 1;
+        priority >= ACTOR_MESSAGE_PRIORITY_NORMAL; priority--) {
+        actor_message_t previous = NULL;
+        for (actor_message_t saved = queue->saved_first[priority]; saved != NULL;
+            saved = (actor_message_t)saved->next) {
+            if (!predicate(saved)) {
+                previous = saved;
 
-    // if first is NULL set last to NULL
-    if (queue->first == NULL) {
-        queue->last = NULL;
+                continue;
+            }
+
+            // unlink matching message
+            if (previous == NULL) {
+                queue->saved_first[priority] = (actor_message_t)saved->next;
+            }
+            else {
+                previous->next = saved->next;
+            }
+            if (queue->saved_last[priority] == saved) {
+                queue->saved_last[priority] = previous;
+            }
+            saved->next = NULL;
+            *message = saved;
+            actor_message_queue_taken(queue, saved);
+
+            return ACTOR_SUCCESS;
+        }
     }
 
-    // signal read write access
-    dispatch_semaphore_signal(queue->semaphore_read_write);
+    // check new messages
+    return actor_message_queue_get_new_match(queue, message, predicate,
+        timeout);
+}
+
+// get first message matching predicate, which arrived after the messages in
+// the save list
+actor_error_t actor_message_queue_get_new_match(actor_message_queue_t queue,
+    actor_message_t* message, actor_message_predicate_t predicate,
+    actor_time_t timeout) {
+    // check for correct input
+    if ((queue == NULL) || (timeout < 0.0) || (message == NULL) ||
+        (predicate == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
 
-    // set next element of message to NULL
-    newMessage->next = NULL;
+    // init message pointer to NULL;
+    *message = NULL;
 
-    // set message pointer
-    *message = newMessage;
+    // check new messages only, skipped ones are saved in order
+    actor_time_t deadline = actor_message_queue_now() + timeout;
+
+    while (true) {
+        // try to get message without any synchronisation
+        actor_message_t newMessage = actor_message_queue_pop(queue);
+
+        // check message
+        if (newMessage != NULL) {
+            if (predicate(newMessage)) {
+                *message = newMessage;
+                actor_message_queue_taken(queue, newMessage);
+
+                return ACTOR_SUCCESS;
+            }
+
+            actor_message_queue_save(queue, newMessage);
+            actor_message_queue_drop_saved(queue);
+
+            continue;
+        }
+
+        // a producer is linking a message, which is available in a moment
+        if (actor_message_queue_pending(queue)) {
+            sched_yield();
+
+            continue;
+        }
+
+        // wait for producer with remaining time, a wakeup may bring a non
+        // matching message
+        actor_time_t remaining = timeout == 0.0 ? 0.0 :
+            deadline - actor_message_queue_now();
+        if (actor_message_queue_wait_message(queue,
+            remaining > 0.0 ? remaining : 0.0) != ACTOR_SUCCESS) {
+            return ACTOR_ERROR_TIMEOUT;
+        }
+    }
+}
+
+// notify producer once about space in full queue
+actor_error_t actor_message_queue_notify_space(actor_message_queue_t queue,
+    actor_message_queue_notify_function_t function, void* context) {
+    // check for correct input
+    if ((queue == NULL) || (function == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // arm notification
+    __atomic_store_n(&queue->space_notify_context, context, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&queue->space_notify_function, function, __ATOMIC_SEQ_CST);
+
+    // recheck, so that space given free before arming is not missed
+    if ((__atomic_load_n(&queue->count, __ATOMIC_SEQ_CST) <
+        (long)queue->capacity) ||
+        (__atomic_load_n(&queue->closed, __ATOMIC_SEQ_CST) != 0)) {
+        actor_message_queue_space_notify(queue);
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// arm empty queue to notify consumer about next message
+actor_error_t actor_message_queue_arm(actor_message_queue_t queue, bool* armed) {
+    // check for correct input
+    if ((queue == NULL) || (armed == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // announce waiting consumer
+    *armed = true;
+    __atomic_store_n(&queue->waiting, 1, __ATOMIC_SEQ_CST);
+
+    // recheck queue to not miss a message pushed before announcement
+    if (!actor_message_queue_empty(queue)) {
+        // revoke announcement, if no producer took it, otherwise the
+        // producer notifies the consumer
+        if (__atomic_exchange_n(&queue->waiting, 0, __ATOMIC_SEQ_CST) != 0) {
+            *armed = false;
+        }
+    }
 
     return ACTOR_SUCCESS;
 }
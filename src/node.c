@@ -17,13 +17,110 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <sched.h>
+#include <Block.h>
 #include "../include/actor.h"
 
+// get message queue slot by index below message queue count
+static actor_node_slot_t actor_node_get_slot(actor_node_t node,
+    actor_size_t index) {
+    // segment k starts at index (2^k - 1) * segment min size
+    actor_size_t position = index + ACTOR_NODE_SEGMENT_MIN_SIZE;
+    int bit = 31 - __builtin_clz(position);
+    actor_node_slot_t slots = __atomic_load_n(
+        &node->message_queues[bit - ACTOR_NODE_SEGMENT_MIN_BITS],
+        __ATOMIC_ACQUIRE);
+
+    return &slots[position - (1u << bit)];
+}
+
+// append slots first to last to free queue, called with free semaphore held
+static void actor_node_append_free_slots(actor_node_t node, actor_size_t first,
+    actor_size_t last) {
+    if (node->free_last == 0) {
+        node->free_first = (long)first + 1;
+    }
+    else {
+        actor_node_get_slot(node, (actor_size_t)node->free_last - 1)->next_free =
+            (long)first + 1;
+    }
+    actor_node_get_slot(node, last)->next_free = 0;
+    node->free_last = (long)last + 1;
+}
+
+// add segment to process table and append its slots to free queue, capacity
+// is the message queue count seen by the caller
+static actor_error_t actor_node_grow(actor_node_t node, actor_size_t capacity) {
+    // get grow access
+    dispatch_semaphore_wait(node->grow_semaphore, DISPATCH_TIME_FOREVER);
+
+    // check for concurrent growth
+    actor_size_t count = node->message_queue_count;
+    if (count != capacity) {
+        dispatch_semaphore_signal(node->grow_semaphore);
+
+        return ACTOR_SUCCESS;
+    }
+
+    // check for maximum size
+    if (node->segment_count == ACTOR_NODE_SEGMENT_COUNT) {
+        dispatch_semaphore_signal(node->grow_semaphore);
+
+        return ACTOR_ERROR_TOO_MANY_PROCESSES;
+    }
+
+    // create segment
+    actor_size_t size = ACTOR_NODE_SEGMENT_MIN_SIZE << node->segment_count;
+    actor_node_slot_t slots = malloc(sizeof(actor_node_slot_s) * size);
+
+    // check success
+    if (slots == NULL) {
+        dispatch_semaphore_signal(node->grow_semaphore);
+
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // chain slots, lowest index first
+    for (actor_size_t i = 0; i < size; i++) {
+        slots[i].queue = NULL;
+        slots[i].generation = 0;
+        slots[i].producers = 0;
+        slots[i].next_free = count + i + 2;
+    }
+
+    // publish segment before its slots become free
+    __atomic_store_n(&node->message_queues[node->segment_count], slots,
+        __ATOMIC_RELEASE);
+    node->segment_count++;
+    __atomic_store_n(&node->message_queue_count, count + size,
+        __ATOMIC_RELEASE);
+
+    // append chain to free queue
+    dispatch_semaphore_wait(node->free_semaphore, DISPATCH_TIME_FOREVER);
+    actor_node_append_free_slots(node, count, count + size - 1);
+    dispatch_semaphore_signal(node->free_semaphore);
+
+    // release grow access
+    dispatch_semaphore_signal(node->grow_semaphore);
+
+    return ACTOR_SUCCESS;
+}
+
 // create node
 actor_error_t actor_node_create(actor_node_t* nodePointer, actor_node_id_t id,
     actor_size_t size) {
+    return actor_node_create_with_scheduler(nodePointer, id, size,
+        ACTOR_SCHEDULER_DISPATCH);
+}
+
+// create node with given scheduler
+actor_error_t actor_node_create_with_scheduler(actor_node_t* nodePointer,
+    actor_node_id_t id, actor_size_t size, actor_scheduler_type_t scheduler) {
     // check valid input
-    if ((nodePointer == NULL) || (id < 0) || (size <= 0)) {
+    if ((nodePointer == NULL) || (id < 0) || (size <= 0) ||
+        (size > ACTOR_NODE_MAX_PROCESSES) ||
+        ((scheduler != ACTOR_SCHEDULER_DISPATCH) &&
+            (scheduler != ACTOR_SCHEDULER_GREEN))) {
         return ACTOR_ERROR_INVALUE;
     }
 
@@ -40,23 +137,89 @@ actor_error_t actor_node_create(actor_node_t* nodePointer, actor_node_id_t id,
 
     // init struct
     node->id = id;
-    node->message_queues = NULL;
+    node->message_pool = NULL;
+    node->scheduler = NULL;
+    node->timer_wheel = NULL;
+    for (actor_size_t i = 0; i < ACTOR_NODE_SEGMENT_COUNT; i++) {
+        node->message_queues[i] = NULL;
+    }
+    node->segment_count = 0;
+    node->distributer = NULL;
+    node->distributer_notifying = 0;
     node->remote_nodes = NULL;
-    node->message_queue_count = size;
-    node->message_queue_pos = 0;
+    node->distributer_batch_size = ACTOR_DISTRIBUTER_BATCH_SIZE;
+    node->distributer_flush_latency = ACTOR_DISTRIBUTER_FLUSH_LATENCY;
+    node->distributer_checksum = false;
+    node->distributer_compression_threshold =
+        ACTOR_DISTRIBUTER_COMPRESSION_THRESHOLD;
+    node->distributer_max_message_size = ACTOR_DISTRIBUTER_MAX_MESSAGE_SIZE;
+    node->correlation_counter = 0;
+    node->message_queue_count = 0;
+    node->free_first = 0;
+    node->free_last = 0;
+    node->free_semaphore = NULL;
+    node->grow_semaphore = NULL;
     node->process_semaphore = NULL;
-    node->message_queue_create_semaphore = NULL;
     node->process_count = 0;
 
-    // create message queues
-    node->message_queues = malloc(sizeof(actor_message_queue_t) * size);
+    // create message pool
+    actor_error_t error = actor_message_pool_create(&node->message_pool);
 
     // check success
-    if (node->message_queues == NULL) {
+    if (error != ACTOR_SUCCESS) {
         // release node
         actor_node_release(&node);
 
-        return ACTOR_ERROR_MEMORY;
+        return error;
+    }
+
+    // create timer wheel
+    error = actor_timer_wheel_create(&node->timer_wheel);
+
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        // release node
+        actor_node_release(&node);
+
+        return error;
+    }
+
+    // create green process scheduler
+    if (scheduler == ACTOR_SCHEDULER_GREEN) {
+        error = actor_scheduler_create(&node->scheduler, 0, node->timer_wheel);
+
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            // release node
+            actor_node_release(&node);
+
+            return error;
+        }
+    }
+
+    // create free and grow semaphore
+    node->free_semaphore = dispatch_semaphore_create(1);
+    node->grow_semaphore = dispatch_semaphore_create(1);
+
+    // check success
+    if ((node->free_semaphore == NULL) || (node->grow_semaphore == NULL)) {
+        // release node
+        actor_node_release(&node);
+
+        return ACTOR_ERROR_DISPATCH;
+    }
+
+    // preallocate process table for size processes
+    while (node->message_queue_count < size) {
+        error = actor_node_grow(node, node->message_queue_count);
+
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            // release node
+            actor_node_release(&node);
+
+            return error;
+        }
     }
 
     // create remote node array
@@ -75,22 +238,22 @@ actor_error_t actor_node_create(actor_node_t* nodePointer, actor_node_id_t id,
         node->remote_nodes[i] = ACTOR_INVALID_ID;
     }
 
-    // create process semaphore
-    node->process_semaphore = dispatch_semaphore_create(0);
+    // create distributer
+    error = actor_distributer_create(&node->distributer, node);
 
     // check success
-    if (node->process_semaphore == NULL) {
+    if (error != ACTOR_SUCCESS) {
         // release node
         actor_node_release(&node);
 
-        return ACTOR_ERROR_DISPATCH;
+        return error;
     }
 
-    // create message queue create semaphore
-    node->message_queue_create_semaphore = dispatch_semaphore_create(1);
+    // create process semaphore
+    node->process_semaphore = dispatch_semaphore_create(0);
 
     // check success
-    if (node->message_queue_create_semaphore == NULL) {
+    if (node->process_semaphore == NULL) {
         // release node
         actor_node_release(&node);
 
@@ -112,13 +275,62 @@ actor_error_t actor_node_release(actor_node_t* nodePointer) {
     // get node
     actor_node_t node = *nodePointer;
 
+    // close connections
+    if (node->distributer != NULL) {
+        actor_distributer_release(&node->distributer);
+    }
+
+    // stop expiring timers, before their tasks and message queues are gone
+    if (node->timer_wheel != NULL) {
+        actor_timer_wheel_stop(node->timer_wheel);
+    }
+
+    // stop green process scheduler, producers parked on a full message queue
+    // have to leave it first, because their waiters live on the task stacks
+    if (node->scheduler != NULL) {
+        for (actor_size_t i = 0; i < node->segment_count; i++) {
+            for (actor_size_t j = 0; j < (ACTOR_NODE_SEGMENT_MIN_SIZE << i); j++) {
+                actor_message_queue_t queue = node->message_queues[i][j].queue;
+                if (queue == NULL) {
+                    continue;
+                }
+
+                actor_message_queue_close(queue);
+                while (__atomic_load_n(&queue->space_parked,
+                    __ATOMIC_SEQ_CST) != 0) {
+                    sched_yield();
+                }
+            }
+        }
+
+        actor_scheduler_release(&node->scheduler);
+    }
+
     // release message queues
-    if (node->message_queues != NULL) {
-        for (actor_size_t i = 0; i < node->message_queue_count; i++) {
-            actor_message_queue_release(&node->message_queues[i]);
+    for (actor_size_t i = 0; i < node->segment_count; i++) {
+        for (actor_size_t j = 0; j < (ACTOR_NODE_SEGMENT_MIN_SIZE << i); j++) {
+            actor_message_queue_release(&node->message_queues[i][j].queue);
         }
 
-        free(node->message_queues);
+        free(node->message_queues[i]);
+    }
+
+    // release timer wheel, which drops delayed messages
+    if (node->timer_wheel != NULL) {
+        actor_timer_wheel_release(&node->timer_wheel);
+    }
+
+    // release free and grow semaphore
+    if (node->free_semaphore != NULL) {
+        dispatch_release(node->free_semaphore);
+    }
+    if (node->grow_semaphore != NULL) {
+        dispatch_release(node->grow_semaphore);
+    }
+
+    // release message pool
+    if (node->message_pool != NULL) {
+        actor_message_pool_release(&node->message_pool);
     }
 
     // release remote node array
@@ -131,11 +343,6 @@ actor_error_t actor_node_release(actor_node_t* nodePointer) {
         dispatch_release(node->process_semaphore);
     }
 
-    // release message queue create semaphore
-    if (node->message_queue_create_semaphore != NULL) {
-        dispatch_release(node->message_queue_create_semaphore);
-    }
-
     // free memory
     free(node);
 
@@ -145,11 +352,141 @@ actor_error_t actor_node_release(actor_node_t* nodePointer) {
     return ACTOR_SUCCESS;
 }
 
-// spawn new process
-actor_error_t actor_node_spawn_process(actor_node_t node, actor_process_id_t* pid,
+// run reactive process
+static void actor_node_run_reactive_process(void* context);
+
+// notify supervisor about process result and cleanup process
+static void actor_node_exit_process(actor_process_t process,
+    actor_error_t result) {
+    // create error message
+    actor_process_error_message_s error_message;
+    error_message.nid = process->nid;
+    error_message.pid = process->pid;
+    error_message.error = result;
+
+    // send message
+    actor_send(process, process->supervisor_nid,
+        process->supervisor_pid, ACTOR_TYPE_ERROR_MESSAGE, &error_message,
+        sizeof(actor_process_error_message_s));
+
+    // cleanup process
+    actor_process_release(&process);
+}
+
+// run process function and notify supervisor
+static void actor_node_run_process(actor_process_t process,
     actor_process_function_t function) {
+    // call process kernel
+    actor_error_t result = function(process);
+
+    // exit process
+    actor_node_exit_process(process, result);
+}
+
+// schedule run of reactive process
+static void actor_node_schedule_reactive_process(void* context) {
+    actor_process_t process = context;
+
+    // run as scheduler job or on dispatch queue
+    if (process->task != NULL) {
+        actor_scheduler_task_start(process->task);
+    }
+    else {
+        dispatch_async_f(dispatch_get_global_queue(
+            DISPATCH_QUEUE_PRIORITY_HIGH, 0), process,
+            actor_node_run_reactive_process);
+    }
+}
+
+// handle available messages of reactive process
+static void actor_node_run_reactive_process(void* context) {
+    actor_process_t process = context;
+    actor_process_handler_t handler = (actor_process_handler_t)process->function;
+
+    // handle a limited number of messages per run
+    for (actor_size_t i = 0; i < ACTOR_PROCESS_REACTIVE_BATCH_SIZE; i++) {
+        // get message without blocking
+        actor_message_t message = NULL;
+        if (actor_message_queue_get(process->message_queue, &message,
+            0.0) != ACTOR_SUCCESS) {
+            // arm queue, next producer schedules the process again
+            bool armed = false;
+            actor_message_queue_arm(process->message_queue, &armed);
+
+            if (armed) {
+                return;
+            }
+
+            continue;
+        }
+
+        // call handler
+        actor_error_t result = handler(process, message);
+
+        // release message
+        actor_message_release(&message);
+
+        // check for stopped process
+        if ((result != ACTOR_SUCCESS) || process->stopped) {
+            // release handler and job
+            Block_release(handler);
+            process->function = NULL;
+            if (process->task != NULL) {
+                actor_scheduler_job_release(&process->task);
+            }
+
+            // exit process
+            actor_node_exit_process(process, result);
+
+            return;
+        }
+    }
+
+    // give other processes a chance and continue later
+    actor_node_schedule_reactive_process(process);
+}
+
+// cleanup process, whose task or job did not finish before the scheduler
+// was released
+static void actor_node_release_process(void* context) {
+    actor_process_t process = context;
+
+    // task is freed by the scheduler
+    process->task = NULL;
+    process->message_queue->task = NULL;
+
+    // release process function
+    if (process->function != NULL) {
+        Block_release(process->function);
+        process->function = NULL;
+    }
+
+    // cleanup process
+    actor_process_release(&process);
+}
+
+// entry point of green process
+static void actor_node_green_process_main(void* context) {
+    actor_process_t process = context;
+
+    // get process function, which stays with the process until it exits
+    actor_process_function_t function =
+        (actor_process_function_t)process->function;
+
+    // run process
+    actor_node_run_process(process, function);
+
+    // release process function
+    Block_release(function);
+}
+
+// start new process as green task or on dispatch queue
+static actor_error_t actor_node_start_process(actor_node_t node,
+    actor_process_id_t* pid, actor_process_function_t function, bool blocking,
+    actor_size_t capacity, actor_message_queue_policy_t policy,
+    actor_time_t timeout) {
     // check for valid node
-    if (node == NULL) {
+    if ((node == NULL) || (function == NULL)) {
         return ACTOR_ERROR_INVALUE;
     }
 
@@ -170,71 +507,437 @@ actor_error_t actor_node_spawn_process(actor_node_t node, actor_process_id_t* pi
         return error;
     }
 
-    // get dispatch queue
-    dispatch_queue_t dispatch_queue = dispatch_get_global_queue(
-        DISPATCH_QUEUE_PRIORITY_HIGH, 0);
+    // limit mailbox, before the pid is known to any sender
+    error = actor_message_queue_set_capacity(process->message_queue, capacity,
+        policy, timeout);
 
-    // check for success
-    if (dispatch_queue == NULL) {
-        // cleanup
+    // check success
+    if (error != ACTOR_SUCCESS) {
         actor_process_release(&process);
 
-        return ACTOR_ERROR_DISPATCH;
+        return error;
     }
 
-    // invoke new procces
-    dispatch_async(dispatch_queue, ^ {
-        // call process kernel
-        actor_error_t result = function(process);
+    // remember pid, process may finish before start returns
+    actor_process_id_t process_pid = process->pid;
 
-        // create error message
-        actor_process_error_message_s error_message;
-        error_message.nid = process->nid;
-        error_message.pid = process->pid;
-        error_message.error = result;
+    // start process
+    if ((node->scheduler != NULL) && !blocking) {
+        // keep process function
+        process->function = (void*)Block_copy(function);
 
-        // send message
-        actor_send(process, process->supervisor_nid,
-            process->supervisor_pid, ACTOR_TYPE_ERROR_MESSAGE, &error_message,
-            sizeof(actor_process_error_message_s));
+        // create green task
+        error = actor_scheduler_task_create(node->scheduler, &process->task,
+            actor_node_green_process_main, actor_node_release_process,
+            process);
 
-        // cleanup process
-        actor_process_release(&process);
-    });
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            // cleanup
+            Block_release(process->function);
+            process->function = NULL;
+            actor_process_release(&process);
+
+            return error;
+        }
+
+        // park and unpark task instead of waiting on semaphores
+        process->message_queue->task = process->task;
+
+        // invoke new process
+        actor_scheduler_task_start(process->task);
+    }
+    else {
+        // get dispatch queue
+        dispatch_queue_t dispatch_queue = dispatch_get_global_queue(
+            DISPATCH_QUEUE_PRIORITY_HIGH, 0);
+
+        // check for success
+        if (dispatch_queue == NULL) {
+            // cleanup
+            actor_process_release(&process);
+
+            return ACTOR_ERROR_DISPATCH;
+        }
+
+        // invoke new procces
+        dispatch_async(dispatch_queue, ^ {
+            actor_node_run_process(process, function);
+        });
+    }
+
+    // set pid
+    if (pid != NULL) {
+        *pid = process_pid;
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// spawn new process
+actor_error_t actor_node_spawn_process(actor_node_t node, actor_process_id_t* pid,
+    actor_process_function_t function) {
+    return actor_node_start_process(node, pid, function, false, 0,
+        ACTOR_MESSAGE_QUEUE_BLOCK, 0.0);
+}
+
+// spawn new process with bounded mailbox
+actor_error_t actor_node_spawn_bounded_process(actor_node_t node,
+    actor_process_id_t* pid, actor_size_t capacity,
+    actor_message_queue_policy_t policy, actor_time_t timeout,
+    actor_process_function_t function) {
+    return actor_node_start_process(node, pid, function, false, capacity,
+        policy, timeout);
+}
+
+// spawn new reactive process
+actor_error_t actor_node_spawn_reactive_process(actor_node_t node,
+    actor_process_id_t* pid, actor_process_handler_t handler) {
+    // check for valid node
+    if ((node == NULL) || (handler == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // error
+    actor_error_t error = ACTOR_SUCCESS;
+
+    // init pid to invalid
+    if (pid != NULL) {
+        *pid = ACTOR_INVALID_ID;
+    }
+
+    // create process
+    actor_process_t process = NULL;
+    error = actor_process_create(node, &process);
+
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        return error;
+    }
+
+    // keep handler
+    process->reactive = true;
+    process->function = (void*)Block_copy(handler);
+
+    // create scheduler job, which needs no stack
+    if (node->scheduler != NULL) {
+        error = actor_scheduler_job_create(node->scheduler, &process->task,
+            actor_node_run_reactive_process, actor_node_release_process,
+            process);
+
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            // cleanup
+            Block_release(process->function);
+            process->function = NULL;
+            actor_process_release(&process);
+
+            return error;
+        }
+    }
 
     // set pid
     if (pid != NULL) {
         *pid = process->pid;
     }
 
+    // get notified about first message
+    bool armed = false;
+    process->message_queue->notify_function = actor_node_schedule_reactive_process;
+    process->message_queue->notify_context = process;
+    actor_message_queue_arm(process->message_queue, &armed);
+
     return ACTOR_SUCCESS;
 }
 
+// spawn new process with own thread
+actor_error_t actor_node_spawn_blocking_process(actor_node_t node,
+    actor_process_id_t* pid, actor_process_function_t function) {
+    return actor_node_start_process(node, pid, function, true, 0,
+        ACTOR_MESSAGE_QUEUE_BLOCK, 0.0);
+}
+
 // message sending
 actor_error_t actor_node_send_message(actor_node_t node,
     actor_node_id_t destination_nid, actor_process_id_t destination_pid,
     actor_data_type_t type, actor_message_data_t const data, actor_size_t size) {
+    // send without source
+    return actor_node_send_message_from(node, ACTOR_INVALID_ID,
+        destination_nid, destination_pid, type, data, size, 0, false);
+}
+
+// create and deliver message on behalf of local source process
+static actor_error_t actor_node_send(actor_node_t node,
+    actor_process_id_t source_pid, actor_node_id_t destination_nid,
+    actor_process_id_t destination_pid, actor_data_type_t type,
+    actor_message_data_t const data, actor_size_t size,
+    unsigned int correlation_id, bool reply, bool system) {
     // check input
-    if ((node == NULL) || (data == NULL) || (type < 0)) {
+    if ((node == NULL) || (data == NULL) || (type < 0) ||
+        (correlation_id > ACTOR_MESSAGE_MAX_CORRELATION_ID)) {
         return ACTOR_ERROR_INVALUE;
     }
 
-    // error
-    actor_error_t error = ACTOR_SUCCESS;
+    // create message
+    actor_message_t message = NULL;
+    if (actor_message_create_pooled(node->message_pool, &message, type, data,
+        size) != ACTOR_SUCCESS) {
+        return ACTOR_ERROR_MEMORY;
+    }
 
-    // check destination nid
-    if ((destination_nid < 0) || (destination_nid >= ACTOR_NODE_MAX_REMOTE_NODES)) {
+    // set message destination
+    message->destination_nid = destination_nid;
+    message->destination_pid = destination_pid;
+
+    // set source and correlation
+    if (source_pid != ACTOR_INVALID_ID) {
+        message->source_nid = node->id;
+        message->source_pid = source_pid;
+    }
+    message->correlation_id = correlation_id;
+    message->reply = reply;
+    if (system) {
+        message->priority = ACTOR_MESSAGE_PRIORITY_SYSTEM;
+    }
+
+    // deliver message
+    actor_error_t error = actor_node_deliver_message(node, message);
+
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        // release message
+        actor_message_release(&message);
+    }
+
+    return error;
+}
+
+// message sending on behalf of local source process
+actor_error_t actor_node_send_message_from(actor_node_t node,
+    actor_process_id_t source_pid, actor_node_id_t destination_nid,
+    actor_process_id_t destination_pid, actor_data_type_t type,
+    actor_message_data_t const data, actor_size_t size,
+    unsigned int correlation_id, bool reply) {
+    return actor_node_send(node, source_pid, destination_nid, destination_pid,
+        type, data, size, correlation_id, reply, false);
+}
+
+// message sending with system priority
+actor_error_t actor_node_send_system_message(actor_node_t node,
+    actor_process_id_t source_pid, actor_node_id_t destination_nid,
+    actor_process_id_t destination_pid, actor_data_type_t type,
+    actor_message_data_t const data, actor_size_t size) {
+    return actor_node_send(node, source_pid, destination_nid, destination_pid,
+        type, data, size, 0, false, true);
+}
+
+// delayed or periodic message, referenced by the timer wheel while its
+// timer is pending and by its handle
+struct actor_node_timer_s {
+    actor_timer_s timer;
+    actor_node_t node;
+    actor_message_payload_t payload;
+    actor_data_type_t type;
+    actor_process_id_t source_pid;
+    actor_node_id_t destination_nid;
+    actor_process_id_t destination_pid;
+    long references;
+};
+
+// release reference of delayed message
+static void actor_node_timer_release(void* context) {
+    actor_node_timer_t timer = context;
+
+    if (__atomic_sub_fetch(&timer->references, 1, __ATOMIC_ACQ_REL) == 0) {
+        actor_message_payload_release(&timer->payload);
+        free(timer);
+    }
+}
+
+// deliver delayed message, the timer wheel must not block, so a full
+// mailbox drops it
+static void actor_node_timer_expire(void* context) {
+    actor_node_timer_t timer = context;
+
+    // create message referencing payload
+    actor_message_t message = NULL;
+    if (actor_message_create_shared(timer->node->message_pool, &message,
+        timer->type, timer->payload) == ACTOR_SUCCESS) {
+        // set message destination and source
+        message->destination_nid = timer->destination_nid;
+        message->destination_pid = timer->destination_pid;
+        if (timer->source_pid != ACTOR_INVALID_ID) {
+            message->source_nid = timer->node->id;
+            message->source_pid = timer->source_pid;
+        }
+
+        // deliver message
+        if (actor_node_try_deliver_message(timer->node, message) !=
+            ACTOR_SUCCESS) {
+            actor_message_release(&message);
+        }
+    }
+
+    // release reference of timer wheel after last message
+    if (timer->timer.period == 0) {
+        actor_node_timer_release(timer);
+    }
+}
+
+// add delayed or periodic message to timer wheel
+static actor_error_t actor_node_send_timed(actor_node_t node,
+    actor_process_id_t source_pid, actor_time_t delay, actor_time_t period,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size,
+    actor_node_timer_t* timerPointer) {
+    // check input, destination is checked here, because errors of the
+    // delivery cannot be reported
+    if ((node == NULL) || (data == NULL) || (type < 0) || (delay < 0.0) ||
+        (period < 0.0) || (destination_nid < 0) ||
+        (destination_nid >= ACTOR_NODE_MAX_REMOTE_NODES) ||
+        (destination_pid < 0)) {
         return ACTOR_ERROR_INVALUE;
     }
 
-    // check destination pid
-    if (destination_pid < 0) {
+    // init timer pointer to NULL
+    if (timerPointer != NULL) {
+        *timerPointer = NULL;
+    }
+
+    // create timer struct
+    actor_node_timer_t timer = malloc(sizeof(struct actor_node_timer_s));
+
+    // check success
+    if (timer == NULL) {
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // init struct, the handle holds a reference of its own
+    timer->node = node;
+    timer->payload = NULL;
+    timer->type = type;
+    timer->source_pid = source_pid;
+    timer->destination_nid = destination_nid;
+    timer->destination_pid = destination_pid;
+    timer->references = timerPointer != NULL ? 2 : 1;
+    actor_timer_init(&timer->timer, actor_node_timer_expire,
+        actor_node_timer_release, timer);
+
+    // copy data once into shared payload
+    actor_error_t error = actor_message_payload_create(&timer->payload, data,
+        size);
+
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        free(timer);
+
+        return error;
+    }
+
+    // add timer, the reference of the timer wheel is released after the
+    // last message
+    error = actor_timer_wheel_add_periodic(node->timer_wheel, &timer->timer,
+        delay, period);
+
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        actor_message_payload_release(&timer->payload);
+        free(timer);
+
+        return error;
+    }
+
+    // set timer pointer
+    if (timerPointer != NULL) {
+        *timerPointer = timer;
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// message sending after delay
+actor_error_t actor_node_send_message_after(actor_node_t node,
+    actor_process_id_t source_pid, actor_time_t delay,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size,
+    actor_node_timer_t* timer) {
+    return actor_node_send_timed(node, source_pid, delay, 0.0,
+        destination_nid, destination_pid, type, data, size, timer);
+}
+
+// periodic message sending
+actor_error_t actor_node_send_message_interval(actor_node_t node,
+    actor_process_id_t source_pid, actor_time_t period,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size,
+    actor_node_timer_t* timer) {
+    // check input, periodic messages can only be stopped by their handle
+    if ((period <= 0.0) || (timer == NULL)) {
         return ACTOR_ERROR_INVALUE;
     }
 
-    // create message
+    return actor_node_send_timed(node, source_pid, period, period,
+        destination_nid, destination_pid, type, data, size, timer);
+}
+
+// cancel delayed or periodic message
+actor_error_t actor_node_cancel_timer(actor_node_t node,
+    actor_node_timer_t* timerPointer) {
+    // check input
+    if ((node == NULL) || (timerPointer == NULL) || (*timerPointer == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // get timer
+    actor_node_timer_t timer = *timerPointer;
+
+    // remove timer, which releases the reference of the timer wheel
+    actor_error_t error = actor_timer_wheel_remove(node->timer_wheel,
+        &timer->timer);
+    if (error == ACTOR_SUCCESS) {
+        actor_node_timer_release(timer);
+    }
+
+    // release reference of handle
+    actor_node_timer_release(timer);
+
+    // set timer pointer to NULL
+    *timerPointer = NULL;
+
+    return error;
+}
+
+// get new correlation id for a call
+actor_error_t actor_node_get_correlation_id(actor_node_t node,
+    unsigned int* correlation_id) {
+    // check input
+    if ((node == NULL) || (correlation_id == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // skip 0, which marks messages without correlation
+    do {
+        *correlation_id = __atomic_add_fetch(&node->correlation_counter, 1,
+            __ATOMIC_RELAXED) & ACTOR_MESSAGE_MAX_CORRELATION_ID;
+    } while (*correlation_id == 0);
+
+    return ACTOR_SUCCESS;
+}
+
+// message sending without copy
+actor_error_t actor_node_send_message_owned(actor_node_t node,
+    actor_node_id_t destination_nid, actor_process_id_t destination_pid,
+    actor_data_type_t type, actor_message_data_t data, actor_size_t size,
+    actor_message_free_function_t free_function) {
+    // check input
+    if ((node == NULL) || (data == NULL) || (type < 0)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // create message around data
     actor_message_t message = NULL;
-    if (actor_message_create(&message, type, data, size) != ACTOR_SUCCESS) {
+    if (actor_message_create_owned(node->message_pool, &message, type, data,
+        size, free_function) != ACTOR_SUCCESS) {
         return ACTOR_ERROR_MEMORY;
     }
 
@@ -242,117 +945,302 @@ actor_error_t actor_node_send_message(actor_node_t node,
     message->destination_nid = destination_nid;
     message->destination_pid = destination_pid;
 
-    // destination message queue
-    actor_message_queue_t* queue = NULL;
+    // deliver message
+    actor_error_t error = actor_node_deliver_message(node, message);
 
-    // check node id
-    if (destination_nid == node->id) {
-        // get message queue
-        error = actor_node_get_message_queue(node, &queue, destination_pid);
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        // data stays owned by caller
+        message->free_function = NULL;
+
+        // release message
+        actor_message_release(&message);
+    }
+
+    return error;
+}
+
+// send one shared copy of data to several destinations
+actor_error_t actor_node_broadcast_message(actor_node_t node,
+    actor_message_destination_s const* destinations, actor_size_t count,
+    actor_data_type_t type, actor_message_data_t const data, actor_size_t size) {
+    // check input
+    if ((node == NULL) || (destinations == NULL) || (data == NULL) ||
+        (type < 0)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // error
+    actor_error_t error = ACTOR_SUCCESS;
+
+    // copy data once into shared payload
+    actor_message_payload_t payload = NULL;
+    error = actor_message_payload_create(&payload, data, size);
+
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        return error;
+    }
+
+    // send message to each destination, remaining destinations are served
+    // even if one delivery fails
+    actor_error_t result = ACTOR_SUCCESS;
+    for (actor_size_t i = 0; i < count; i++) {
+        // create message referencing payload
+        actor_message_t message = NULL;
+        error = actor_message_create_shared(node->message_pool, &message, type,
+            payload);
 
         // check success
         if (error != ACTOR_SUCCESS) {
-            // release message
-            actor_message_release(&message);
+            result = error;
 
-            return error;
+            continue;
         }
-    }
-    else {
-        // get remote node message queue
-        error = actor_node_get_message_queue(node, &queue,
-            node->remote_nodes[destination_nid]);
+
+        // set message destination
+        message->destination_nid = destinations[i].nid;
+        message->destination_pid = destinations[i].pid;
+
+        // deliver message
+        error = actor_node_deliver_message(node, message);
 
         // check success
         if (error != ACTOR_SUCCESS) {
             // release message
             actor_message_release(&message);
 
-            return error;
+            result = error;
         }
     }
 
-    // enqueue message
-    return actor_message_queue_put(*queue, message);
+    // release own reference
+    actor_message_payload_release(&payload);
+
+    return result;
 }
 
-// get free message queue
-actor_error_t actor_node_get_free_message_queue(actor_node_t node,
-    actor_message_queue_t* queue, actor_process_id_t* pid) {
-    // check for correct input
-    if ((node == NULL) || (pid == NULL) || (queue == NULL)) {
+// get index of message queue slot of pid
+static actor_size_t actor_node_pid_index(actor_process_id_t pid) {
+    return (actor_size_t)pid & ((1u << ACTOR_NODE_PID_INDEX_BITS) - 1);
+}
+
+// get generation of message queue slot of pid
+static long actor_node_pid_generation(actor_process_id_t pid) {
+    return (long)((actor_size_t)pid >> ACTOR_NODE_PID_INDEX_BITS);
+}
+
+// free message queue of released slot and append slot to free queue
+static void actor_node_free_slot(actor_node_t node, actor_size_t index) {
+    // only one of releaser and last producer frees the slot
+    actor_node_slot_t slot = actor_node_get_slot(node, index);
+    long producers = ACTOR_NODE_SLOT_RELEASED;
+    if (!__atomic_compare_exchange_n(&slot->producers, &producers, 0, false,
+        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+        return;
+    }
+
+    // release message queue
+    actor_message_queue_t queue = slot->queue;
+    __atomic_store_n(&slot->queue, NULL, __ATOMIC_RELEASE);
+    actor_message_queue_release(&queue);
+
+    // append slot to free queue, so that it is reused as late as possible
+    dispatch_semaphore_wait(node->free_semaphore, DISPATCH_TIME_FOREVER);
+    actor_node_append_free_slots(node, index, index);
+    dispatch_semaphore_signal(node->free_semaphore);
+
+    // decrement process counter and send signal if no process left
+    if (__atomic_sub_fetch(&node->process_count, 1, __ATOMIC_SEQ_CST) == 0) {
+        dispatch_semaphore_signal(node->process_semaphore);
+    }
+}
+
+// leave slot entered by producer, the last one frees a released slot
+static void actor_node_leave_slot(actor_node_t node, actor_size_t index) {
+    actor_node_slot_t slot = actor_node_get_slot(node, index);
+    if (__atomic_sub_fetch(&slot->producers, 1, __ATOMIC_SEQ_CST) ==
+        ACTOR_NODE_SLOT_RELEASED) {
+        actor_node_free_slot(node, index);
+    }
+}
+
+// enter slot of pid as producer, so that its message queue stays valid
+// until the slot is left, even if the process releases it meanwhile
+static actor_error_t actor_node_enter_slot(actor_node_t node,
+    actor_process_id_t pid, actor_node_slot_t* slotPointer) {
+    // check for correct pid
+    actor_size_t index = actor_node_pid_index(pid);
+    if ((pid < 0) || (index >=
+        __atomic_load_n(&node->message_queue_count, __ATOMIC_ACQUIRE))) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // announce producer before checking for recycled slot, a release
+    // bumping the generation later sees the announcement
+    actor_node_slot_t slot = actor_node_get_slot(node, index);
+    __atomic_add_fetch(&slot->producers, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&slot->generation, __ATOMIC_SEQ_CST) !=
+        actor_node_pid_generation(pid)) {
+        actor_node_leave_slot(node, index);
+
+        return ACTOR_ERROR_STALE_PROCESS;
+    }
+
+    // set slot pointer
+    *slotPointer = slot;
+
+    return ACTOR_SUCCESS;
+}
+
+// deliver message to local or remote destination, optionally waiting for
+// space in a full mailbox or getting notified about it
+static actor_error_t actor_node_put_message(actor_node_t node,
+    actor_message_t message, bool blocking,
+    actor_message_queue_notify_function_t function, void* context) {
+    // check input
+    if ((node == NULL) || (message == NULL)) {
         return ACTOR_ERROR_INVALUE;
     }
 
     // error
     actor_error_t error = ACTOR_SUCCESS;
 
-    // init queue and pid pointer
-    *queue = NULL;
-    *pid = ACTOR_INVALID_ID;
-
-    // get message queue create access
-    dispatch_semaphore_wait(node->message_queue_create_semaphore,
-        DISPATCH_TIME_FOREVER);
+    // get destination
+    actor_node_id_t destination_nid = message->destination_nid;
+    actor_process_id_t destination_pid = message->destination_pid;
 
-    // get possible id
-    actor_process_id_t id = node->message_queue_pos;
+    // check destination nid
+    if ((destination_nid < 0) || (destination_nid >= ACTOR_NODE_MAX_REMOTE_NODES)) {
+        return ACTOR_ERROR_INVALUE;
+    }
 
-    // check for correct id
-    if ((id >= node->message_queue_count) ||
-            (node->message_queues[id] != NULL)) {
-        // look for first free queue
-        for (actor_size_t i = 0; i < node->message_queue_count; i++) {
-            // check for used queue
-            if (node->message_queues[i] == NULL) {
-                // set new id
-                id = i;
+    // check destination pid
+    if (destination_pid < 0) {
+        return ACTOR_ERROR_INVALUE;
+    }
 
-                break;
-            }
-        }
+    // resolve remote node to its connection process
+    if (destination_nid != node->id) {
+        destination_pid = node->remote_nodes[destination_nid];
+    }
 
-        // check new id
-        if (id == node->message_queue_pos) {
-            // release message queue create access
-            dispatch_semaphore_signal(node->message_queue_create_semaphore);
+    // enter slot of destination, so that its message queue is not freed
+    // while the message is put
+    actor_node_slot_t slot = NULL;
+    error = actor_node_enter_slot(node, destination_pid, &slot);
 
-            return ACTOR_ERROR_TOO_MANY_PROCESSES;
-        }
+    // check success
+    if (error != ACTOR_SUCCESS) {
+        return error;
+    }
 
-        // set new id
-        *pid = id;
-        node->message_queue_pos = id + 1;
+    // enqueue message
+    actor_message_queue_t queue = __atomic_load_n(&slot->queue,
+        __ATOMIC_ACQUIRE);
+    if (!blocking) {
+        error = actor_message_queue_try_put(queue, message);
     }
     else {
-        // set id
-        *pid = node->message_queue_pos;
+        error = actor_message_queue_put(queue, message);
+    }
 
-        // increment count
-        node->message_queue_pos++;
+    // notify about space, while the queue is kept by the slot
+    if ((error == ACTOR_ERROR_MAILBOX_FULL) && (function != NULL)) {
+        actor_message_queue_notify_space(queue, function, context);
     }
 
+    // leave slot
+    actor_node_leave_slot(node, actor_node_pid_index(destination_pid));
+
+    return error;
+}
+
+// deliver message to local or remote destination
+actor_error_t actor_node_deliver_message(actor_node_t node,
+    actor_message_t message) {
+    return actor_node_put_message(node, message, true, NULL, NULL);
+}
+
+// deliver message without waiting for space in a full mailbox
+actor_error_t actor_node_try_deliver_message(actor_node_t node,
+    actor_message_t message) {
+    return actor_node_put_message(node, message, false, NULL, NULL);
+}
+
+// deliver message without waiting and get notified about space in a full
+// mailbox
+actor_error_t actor_node_try_deliver_message_notify(actor_node_t node,
+    actor_message_t message, actor_message_queue_notify_function_t function,
+    void* context) {
+    return actor_node_put_message(node, message, false, function, context);
+}
+
+// get free message queue
+actor_error_t actor_node_get_free_message_queue(actor_node_t node,
+    actor_message_queue_t* queue, actor_process_id_t* pid) {
+    // check for correct input
+    if ((node == NULL) || (pid == NULL) || (queue == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // error
+    actor_error_t error = ACTOR_SUCCESS;
+
+    // init queue and pid pointer
+    *queue = NULL;
+    *pid = ACTOR_INVALID_ID;
+
     // create new message queue
     actor_message_queue_t newQueue = NULL;
     error = actor_message_queue_create(&newQueue);
 
     // check success
     if (error != ACTOR_SUCCESS) {
-        // release message queue create access
-        dispatch_semaphore_signal(node->message_queue_create_semaphore);
-
         return error;
     }
 
+    // take first slot of free queue
+    actor_size_t index = 0;
+    while (true) {
+        dispatch_semaphore_wait(node->free_semaphore, DISPATCH_TIME_FOREVER);
+        if (node->free_first != 0) {
+            index = (actor_size_t)node->free_first - 1;
+            node->free_first = actor_node_get_slot(node, index)->next_free;
+            if (node->free_first == 0) {
+                node->free_last = 0;
+            }
+            dispatch_semaphore_signal(node->free_semaphore);
+
+            break;
+        }
+        actor_size_t capacity = node->message_queue_count;
+        dispatch_semaphore_signal(node->free_semaphore);
+
+        // grow process table without free slot
+        error = actor_node_grow(node, capacity);
+
+        // check success
+        if (error != ACTOR_SUCCESS) {
+            actor_message_queue_release(&newQueue);
+
+            return error;
+        }
+    }
+
     // register queue
-    node->message_queues[*pid] = newQueue;
+    actor_node_slot_t slot = actor_node_get_slot(node, index);
+    __atomic_store_n(&slot->queue, newQueue, __ATOMIC_RELEASE);
 
-    // increment process counter
-    node->process_count++;
-    dispatch_semaphore_wait(node->process_semaphore, DISPATCH_TIME_NOW);
+    // set pid
+    *pid = (actor_process_id_t)(((actor_size_t)__atomic_load_n(&slot->generation,
+        __ATOMIC_RELAXED) << ACTOR_NODE_PID_INDEX_BITS) | index);
 
-    // release message queue create access
-    dispatch_semaphore_signal(node->message_queue_create_semaphore);
+    // increment process counter, a previous signal for no process left is
+    // outdated
+    if (__atomic_fetch_add(&node->process_count, 1, __ATOMIC_SEQ_CST) == 0) {
+        dispatch_semaphore_wait(node->process_semaphore, DISPATCH_TIME_NOW);
+    }
 
     // set queue pointer
     *queue = newQueue;
@@ -364,17 +1252,25 @@ actor_error_t actor_node_get_free_message_queue(actor_node_t node,
 actor_error_t actor_node_get_message_queue(actor_node_t node,
     actor_message_queue_t** queue, actor_process_id_t pid) {
     // check for valid input
-    if ((node == NULL) || (queue == NULL)) {
+    if ((node == NULL) || (queue == NULL) || (pid < 0)) {
         return ACTOR_ERROR_INVALUE;
     }
 
     // check for correct pid
-    if ((pid >= node->message_queue_count) || (pid < 0)) {
+    actor_size_t index = actor_node_pid_index(pid);
+    if (index >= __atomic_load_n(&node->message_queue_count, __ATOMIC_ACQUIRE)) {
         return ACTOR_ERROR_INVALUE;
     }
 
+    // check for recycled slot
+    actor_node_slot_t slot = actor_node_get_slot(node, index);
+    if (__atomic_load_n(&slot->generation, __ATOMIC_ACQUIRE) !=
+        actor_node_pid_generation(pid)) {
+        return ACTOR_ERROR_STALE_PROCESS;
+    }
+
     // set queue pointer
-    *queue = &node->message_queues[pid];
+    *queue = &slot->queue;
 
     return ACTOR_SUCCESS;
 }
@@ -383,22 +1279,30 @@ actor_error_t actor_node_get_message_queue(actor_node_t node,
 actor_error_t actor_node_message_queue_release(actor_node_t node,
     actor_process_id_t pid) {
     // check for correct pid
-    if ((pid >= node->message_queue_count) || (pid < 0)) {
+    actor_size_t index = actor_node_pid_index(pid);
+    if ((node == NULL) || (pid < 0) || (index >=
+        __atomic_load_n(&node->message_queue_count, __ATOMIC_ACQUIRE))) {
         return ACTOR_ERROR_INVALUE;
     }
 
-    // release message queue
-    actor_message_queue_release(&node->message_queues[pid]);
+    // get slot
+    actor_node_slot_t slot = actor_node_get_slot(node, index);
+    if (__atomic_load_n(&slot->generation, __ATOMIC_ACQUIRE) !=
+        actor_node_pid_generation(pid)) {
+        return ACTOR_ERROR_STALE_PROCESS;
+    }
 
-    // set queue pointer to NULL
-    node->message_queues[pid] = NULL;
+    // invalidate pid, producers entering the slot later fail
+    __atomic_store_n(&slot->generation, (slot->generation + 1) &
+        ((1 << ACTOR_NODE_PID_GENERATION_BITS) - 1), __ATOMIC_SEQ_CST);
 
-    // decrement process counter
-    node->process_count--;
+    // refuse further messages and send waiting producers away
+    actor_message_queue_close(slot->queue);
 
-    // send signal if no process left
-    if (node->process_count == 0) {
-        dispatch_semaphore_signal(node->process_semaphore);
+    // mark slot as released, the last producer in it frees it otherwise
+    if (__atomic_add_fetch(&slot->producers, ACTOR_NODE_SLOT_RELEASED,
+        __ATOMIC_SEQ_CST) == ACTOR_NODE_SLOT_RELEASED) {
+        actor_node_free_slot(node, index);
     }
 
     return ACTOR_SUCCESS;
@@ -436,7 +1340,19 @@ actor_error_t actor_node_connect(actor_node_t node, actor_node_id_t* nid,
     return actor_distributer_connect_to_node(node, nid, host_name, host_port, key);
 }
 
-// listen for incomming connection
+// accept any number of incomming connections on port
+actor_error_t actor_node_start_listener(actor_node_t node, unsigned int port,
+    const char* key) {
+    // check for valid node
+    if (node == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // start listener
+    return actor_distributer_start_listener(node, port, key);
+}
+
+// wait for next incomming connection on port
 actor_error_t actor_node_listen(actor_node_t node, actor_node_id_t* nid,
     unsigned int port, const char* key) {
     // check for valid node
@@ -448,6 +1364,30 @@ actor_error_t actor_node_listen(actor_node_t node, actor_node_id_t* nid,
     return actor_distributer_listen(node, nid, port, key);
 }
 
+// accept any number of incomming connections on endpoint
+actor_error_t actor_node_start_listener_endpoint(actor_node_t node,
+    const char* endpoint, const char* key) {
+    // check for valid node
+    if (node == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // start listener
+    return actor_distributer_start_listener_endpoint(node, endpoint, key);
+}
+
+// wait for next incomming connection on endpoint
+actor_error_t actor_node_listen_endpoint(actor_node_t node, actor_node_id_t* nid,
+    const char* endpoint, const char* key) {
+    // check for valid node
+    if (node == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // start listening
+    return actor_distributer_listen_endpoint(node, nid, endpoint, key);
+}
+
 // close connection
 actor_error_t actor_node_disconnect(actor_node_t node, actor_node_id_t nid) {
     // check for valid node
@@ -458,3 +1398,50 @@ actor_error_t actor_node_disconnect(actor_node_t node, actor_node_id_t nid) {
     // disconnect
     return actor_distributer_disconnect_from_node(node, nid);
 }
+
+// configure batching of messages to remote nodes
+actor_error_t actor_node_configure_batching(actor_node_t node,
+    actor_size_t batch_size, actor_time_t flush_latency) {
+    // check for valid node
+    if (node == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // configure distributer
+    return actor_distributer_configure_batching(node, batch_size, flush_latency);
+}
+
+// enable checksums of messages to remote nodes
+actor_error_t actor_node_configure_checksum(actor_node_t node, bool enabled) {
+    // check for valid node
+    if (node == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // configure distributer
+    return actor_distributer_configure_checksum(node, enabled);
+}
+
+// compress messages to remote nodes of at least threshold bytes
+actor_error_t actor_node_configure_compression(actor_node_t node,
+    actor_size_t threshold) {
+    // check for valid node
+    if (node == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // configure distributer
+    return actor_distributer_configure_compression(node, threshold);
+}
+
+// limit size of messages received from remote nodes
+actor_error_t actor_node_configure_max_message_size(actor_node_t node,
+    actor_size_t size) {
+    // check for valid node
+    if (node == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // configure distributer
+    return actor_distributer_configure_max_message_size(node, size);
+}
@@ -0,0 +1,506 @@
+// libactor
+//
+// Implementation of an erlang style actor model using libdispatch
+// Copyright (C) 2012  Patrik Gebhardt
+// Contact: patrik.gebhardt@rub.de
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "../include/actor.h"
+
+// get size class for payload size
+static int actor_message_pool_class(actor_size_t size) {
+    int size_class = 0;
+    actor_size_t capacity = ACTOR_MESSAGE_POOL_MIN_SIZE;
+
+    while (capacity < size) {
+        capacity <<= 2;
+        size_class++;
+    }
+
+    return size_class;
+}
+
+// get payload capacity of size class
+static actor_size_t actor_message_pool_capacity(int size_class) {
+    return ACTOR_MESSAGE_POOL_MIN_SIZE << (2 * size_class);
+}
+
+// free linked list of messages
+static void actor_message_pool_free_list(actor_message_t message) {
+    while (message != NULL) {
+        actor_message_t next = (actor_message_t)message->next;
+        free(message);
+        message = next;
+    }
+}
+
+// caches of the calling thread, reclaimed by a single destructor at thread exit
+static pthread_key_t actor_message_pool_thread_key;
+static pthread_once_t actor_message_pool_thread_once = PTHREAD_ONCE_INIT;
+static bool actor_message_pool_thread_key_created = false;
+
+// lock for binding caches to pools, taken before any depot semaphore
+static pthread_mutex_t actor_message_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// move cached messages of exiting thread to depots and free its caches
+static void actor_message_pool_thread_release(void* context) {
+    actor_message_pool_cache_t cache = context;
+
+    pthread_mutex_lock(&actor_message_pool_lock);
+
+    while (cache != NULL) {
+        actor_message_pool_cache_t next = cache->thread_next;
+        actor_message_pool_t pool = cache->pool;
+
+        // messages of a released pool are already freed
+        if (pool != NULL) {
+            // unbind from thread for destructors running later
+            pthread_setspecific(pool->cache_key, NULL);
+
+            // get depot access
+            dispatch_semaphore_wait(pool->depot_semaphore,
+                DISPATCH_TIME_FOREVER);
+
+            // move messages
+            for (int i = 0; i < ACTOR_MESSAGE_POOL_CLASS_COUNT; i++) {
+                while (cache->messages[i] != NULL) {
+                    actor_message_t message = cache->messages[i];
+                    cache->messages[i] = (actor_message_t)message->next;
+
+                    // check depot size
+                    if (pool->depot_counts[i] < ACTOR_MESSAGE_POOL_DEPOT_SIZE) {
+                        message->next = (struct actor_message_s*)pool->depot[i];
+                        pool->depot[i] = message;
+                        pool->depot_counts[i]++;
+                    }
+                    else {
+                        free(message);
+                    }
+                }
+            }
+
+            // release depot access
+            dispatch_semaphore_signal(pool->depot_semaphore);
+
+            // keep statistics
+            __atomic_add_fetch(&pool->hits, cache->hits, __ATOMIC_RELAXED);
+            __atomic_add_fetch(&pool->misses, cache->misses, __ATOMIC_RELAXED);
+            __atomic_add_fetch(&pool->puts, cache->puts, __ATOMIC_RELAXED);
+
+            // unregister cache
+            actor_message_pool_cache_t* link = &pool->caches;
+            while (*link != NULL) {
+                if (*link == cache) {
+                    *link = cache->next;
+
+                    break;
+                }
+
+                link = &(*link)->next;
+            }
+        }
+
+        // free cache
+        free(cache);
+
+        cache = next;
+    }
+
+    pthread_mutex_unlock(&actor_message_pool_lock);
+}
+
+// create thread key once
+static void actor_message_pool_thread_init(void) {
+    actor_message_pool_thread_key_created = pthread_key_create(
+        &actor_message_pool_thread_key,
+        actor_message_pool_thread_release) == 0;
+}
+
+// get cache of calling thread
+static actor_message_pool_cache_t actor_message_pool_get_cache(
+    actor_message_pool_t pool) {
+    // get existing cache
+    actor_message_pool_cache_t cache = pthread_getspecific(pool->cache_key);
+
+    if (cache != NULL) {
+        return cache;
+    }
+
+    // create thread key
+    pthread_once(&actor_message_pool_thread_once,
+        actor_message_pool_thread_init);
+    if (!actor_message_pool_thread_key_created) {
+        return NULL;
+    }
+
+    // create cache
+    cache = malloc(sizeof(actor_message_pool_cache_s));
+
+    // check success
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    // init struct
+    cache->next = NULL;
+    cache->thread_next = NULL;
+    cache->pool = pool;
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->puts = 0;
+    for (int i = 0; i < ACTOR_MESSAGE_POOL_CLASS_COUNT; i++) {
+        cache->messages[i] = NULL;
+        cache->counts[i] = 0;
+    }
+
+    pthread_mutex_lock(&actor_message_pool_lock);
+
+    // free caches of released pools
+    actor_message_pool_cache_t caches = pthread_getspecific(
+        actor_message_pool_thread_key);
+    actor_message_pool_cache_t* link = &caches;
+    while (*link != NULL) {
+        if ((*link)->pool == NULL) {
+            actor_message_pool_cache_t released = *link;
+            *link = released->thread_next;
+            free(released);
+        }
+        else {
+            link = &(*link)->thread_next;
+        }
+    }
+
+    // bind to thread
+    cache->thread_next = caches;
+    if ((pthread_setspecific(actor_message_pool_thread_key, cache) != 0) ||
+        (pthread_setspecific(pool->cache_key, cache) != 0)) {
+        pthread_setspecific(actor_message_pool_thread_key, caches);
+        pthread_mutex_unlock(&actor_message_pool_lock);
+        free(cache);
+
+        return NULL;
+    }
+
+    // register cache
+    cache->next = pool->caches;
+    pool->caches = cache;
+
+    pthread_mutex_unlock(&actor_message_pool_lock);
+
+    return cache;
+}
+
+// free pool struct
+static void actor_message_pool_free(actor_message_pool_t pool) {
+    // release depot semaphore
+    if (pool->depot_semaphore != NULL) {
+        dispatch_release(pool->depot_semaphore);
+    }
+
+    // free memory
+    free(pool);
+}
+
+// create pool
+actor_error_t actor_message_pool_create(actor_message_pool_t* poolPointer) {
+    // check valid pool pointer
+    if (poolPointer == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // init pool pointer to NULL
+    *poolPointer = NULL;
+
+    // create pool struct
+    actor_message_pool_t pool = malloc(sizeof(actor_message_pool_s));
+
+    // check success
+    if (pool == NULL) {
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // init struct
+    pool->depot_semaphore = NULL;
+    pool->caches = NULL;
+    pool->hits = 0;
+    pool->misses = 0;
+    pool->puts = 0;
+    pool->live = 0;
+    pool->released = false;
+    for (int i = 0; i < ACTOR_MESSAGE_POOL_CLASS_COUNT; i++) {
+        pool->depot[i] = NULL;
+        pool->depot_counts[i] = 0;
+    }
+
+    // create thread cache key, caches are reclaimed through the thread key
+    if (pthread_key_create(&pool->cache_key, NULL) != 0) {
+        free(pool);
+
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // create depot semaphore
+    pool->depot_semaphore = dispatch_semaphore_create(1);
+
+    // check success
+    if (pool->depot_semaphore == NULL) {
+        // release pool
+        actor_message_pool_release(&pool);
+
+        return ACTOR_ERROR_DISPATCH;
+    }
+
+    // set pool pointer
+    *poolPointer = pool;
+
+    return ACTOR_SUCCESS;
+}
+
+// cleanup pool
+actor_error_t actor_message_pool_release(actor_message_pool_t* poolPointer) {
+    // check for valid pool
+    if ((poolPointer == NULL) || (*poolPointer == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // get pool
+    actor_message_pool_t pool = *poolPointer;
+
+    // messages taken from the pool and not yet returned
+    long long live = 0;
+
+    // detach thread caches, their structs are freed by their threads
+    pthread_mutex_lock(&actor_message_pool_lock);
+    for (actor_message_pool_cache_t cache = pool->caches; cache != NULL;
+        cache = cache->next) {
+        live += (long long)(cache->hits + cache->misses - cache->puts);
+
+        for (int i = 0; i < ACTOR_MESSAGE_POOL_CLASS_COUNT; i++) {
+            actor_message_pool_free_list(cache->messages[i]);
+            cache->messages[i] = NULL;
+            cache->counts[i] = 0;
+        }
+
+        cache->pool = NULL;
+    }
+    pool->caches = NULL;
+    pthread_mutex_unlock(&actor_message_pool_lock);
+
+    // delete thread cache key
+    pthread_key_delete(pool->cache_key);
+
+    // free depot
+    for (int i = 0; i < ACTOR_MESSAGE_POOL_CLASS_COUNT; i++) {
+        actor_message_pool_free_list(pool->depot[i]);
+    }
+
+    // messages of finished threads and without cache
+    live += (long long)(pool->hits + pool->misses - pool->puts);
+
+    // messages still alive are freed on return, the last one frees the pool
+    if (live > 0) {
+        pool->live = live;
+        __atomic_store_n(&pool->released, true, __ATOMIC_RELEASE);
+    }
+    else {
+        actor_message_pool_free(pool);
+    }
+
+    // set pool pointer to NULL
+    *poolPointer = NULL;
+
+    return ACTOR_SUCCESS;
+}
+
+// get message with payload capacity for size bytes from pool
+actor_error_t actor_message_pool_get(actor_message_pool_t pool,
+    actor_message_t* messagePointer, actor_size_t size) {
+    // check input
+    if ((pool == NULL) || (messagePointer == NULL) ||
+        (size > ACTOR_MESSAGE_POOL_MAX_SIZE)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // init message pointer to NULL
+    *messagePointer = NULL;
+
+    // get size class and thread cache
+    int size_class = actor_message_pool_class(size);
+    actor_message_pool_cache_t cache = actor_message_pool_get_cache(pool);
+
+    // refill empty cache with a batch from depot, depot count is only a hint
+    if ((cache != NULL) && (cache->messages[size_class] == NULL) &&
+        (pool->depot_counts[size_class] != 0)) {
+        dispatch_semaphore_wait(pool->depot_semaphore, DISPATCH_TIME_FOREVER);
+
+        while ((pool->depot[size_class] != NULL) &&
+            (cache->counts[size_class] < ACTOR_MESSAGE_POOL_CACHE_SIZE / 2)) {
+            actor_message_t message = pool->depot[size_class];
+            pool->depot[size_class] = (actor_message_t)message->next;
+            pool->depot_counts[size_class]--;
+
+            message->next = (struct actor_message_s*)cache->messages[size_class];
+            cache->messages[size_class] = message;
+            cache->counts[size_class]++;
+        }
+
+        dispatch_semaphore_signal(pool->depot_semaphore);
+    }
+
+    // message
+    actor_message_t message = NULL;
+
+    // take cached message
+    if ((cache != NULL) && (cache->messages[size_class] != NULL)) {
+        message = cache->messages[size_class];
+        cache->messages[size_class] = (actor_message_t)message->next;
+        cache->counts[size_class]--;
+        cache->hits++;
+    }
+    else {
+        // allocate new message
+        message = malloc(sizeof(actor_message_s) +
+            actor_message_pool_capacity(size_class));
+
+        // check success
+        if (message == NULL) {
+            return ACTOR_ERROR_MEMORY;
+        }
+
+        // count miss
+        if (cache != NULL) {
+            cache->misses++;
+        }
+        else {
+            __atomic_add_fetch(&pool->misses, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    // init struct
+    message->next = NULL;
+    message->pool = pool;
+    message->capacity = actor_message_pool_capacity(size_class);
+    message->data = message->payload;
+
+    // set message pointer
+    *messagePointer = message;
+
+    return ACTOR_SUCCESS;
+}
+
+// return message to its pool
+actor_error_t actor_message_pool_put(actor_message_t message) {
+    // check input
+    if ((message == NULL) || (message->pool == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // get pool
+    actor_message_pool_t pool = message->pool;
+
+    // free message of released pool
+    if (__atomic_load_n(&pool->released, __ATOMIC_ACQUIRE)) {
+        free(message);
+
+        if (__atomic_sub_fetch(&pool->live, 1, __ATOMIC_ACQ_REL) == 0) {
+            actor_message_pool_free(pool);
+        }
+
+        return ACTOR_SUCCESS;
+    }
+
+    // get size class and thread cache
+    int size_class = actor_message_pool_class(message->capacity);
+    actor_message_pool_cache_t cache = actor_message_pool_get_cache(pool);
+
+    // free message without cache
+    if (cache == NULL) {
+        free(message);
+        __atomic_add_fetch(&pool->puts, 1, __ATOMIC_RELAXED);
+
+        return ACTOR_SUCCESS;
+    }
+
+    // cache message
+    cache->puts++;
+    message->next = (struct actor_message_s*)cache->messages[size_class];
+    cache->messages[size_class] = message;
+    cache->counts[size_class]++;
+
+    // move a batch of messages from full cache to depot
+    if (cache->counts[size_class] >= ACTOR_MESSAGE_POOL_CACHE_SIZE) {
+        dispatch_semaphore_wait(pool->depot_semaphore, DISPATCH_TIME_FOREVER);
+
+        while (cache->counts[size_class] > ACTOR_MESSAGE_POOL_CACHE_SIZE / 2) {
+            message = cache->messages[size_class];
+            cache->messages[size_class] = (actor_message_t)message->next;
+            cache->counts[size_class]--;
+
+            // check depot size
+            if (pool->depot_counts[size_class] < ACTOR_MESSAGE_POOL_DEPOT_SIZE) {
+                message->next = (struct actor_message_s*)pool->depot[size_class];
+                pool->depot[size_class] = message;
+                pool->depot_counts[size_class]++;
+            }
+            else {
+                free(message);
+            }
+        }
+
+        dispatch_semaphore_signal(pool->depot_semaphore);
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// get pool statistics
+actor_error_t actor_message_pool_get_stats(actor_message_pool_t pool,
+    actor_message_pool_stats_t stats) {
+    // check input
+    if ((pool == NULL) || (stats == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // get cache list and depot access
+    pthread_mutex_lock(&actor_message_pool_lock);
+    dispatch_semaphore_wait(pool->depot_semaphore, DISPATCH_TIME_FOREVER);
+
+    // statistics of finished threads and depot
+    stats->hits = __atomic_load_n(&pool->hits, __ATOMIC_RELAXED);
+    stats->misses = __atomic_load_n(&pool->misses, __ATOMIC_RELAXED);
+    stats->bytes_held = 0;
+    for (int i = 0; i < ACTOR_MESSAGE_POOL_CLASS_COUNT; i++) {
+        stats->bytes_held += (unsigned long long)pool->depot_counts[i] *
+            (sizeof(actor_message_s) + actor_message_pool_capacity(i));
+    }
+
+    // add statistics of thread caches, which are updated without lock
+    for (actor_message_pool_cache_t cache = pool->caches; cache != NULL;
+        cache = cache->next) {
+        stats->hits += cache->hits;
+        stats->misses += cache->misses;
+
+        for (int i = 0; i < ACTOR_MESSAGE_POOL_CLASS_COUNT; i++) {
+            stats->bytes_held += (unsigned long long)cache->counts[i] *
+                (sizeof(actor_message_s) + actor_message_pool_capacity(i));
+        }
+    }
+
+    // release cache list and depot access
+    dispatch_semaphore_signal(pool->depot_semaphore);
+    pthread_mutex_unlock(&actor_message_pool_lock);
+
+    return ACTOR_SUCCESS;
+}
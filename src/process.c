@@ -17,8 +17,18 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <time.h>
 #include "../include/actor.h"
 
+// current time in seconds
+static actor_time_t actor_process_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (actor_time_t)now.tv_sec + (actor_time_t)now.tv_nsec /
+        (actor_time_t)NSEC_PER_SEC;
+}
+
 // create process
 actor_error_t actor_process_create(actor_node_t node, actor_process_t* processPointer) {
     // check valid input
@@ -48,6 +58,10 @@ actor_error_t actor_process_create(actor_node_t node, actor_process_t* processPo
     process->supervisor_pid = ACTOR_INVALID_ID;
     process->message_queue = NULL;
     process->sleep_semaphore = NULL;
+    process->task = NULL;
+    process->function = NULL;
+    process->reactive = false;
+    process->stopped = false;
 
     // create sleep semaphore
     process->sleep_semaphore = dispatch_semaphore_create(0);
@@ -110,8 +124,9 @@ actor_error_t actor_process_release(actor_process_t* processPointer) {
 // message receive
 actor_error_t actor_process_receive_message(actor_process_t process, actor_message_t* message,
     actor_time_t timeout) {
-    // check for correct input
-    if ((process == NULL) || (timeout < 0.0) || (message == NULL)) {
+    // check for correct input, reactive processes get messages by handler
+    if ((process == NULL) || (timeout < 0.0) || (message == NULL) ||
+        process->reactive) {
         return ACTOR_ERROR_INVALUE;
     }
 
@@ -119,13 +134,75 @@ actor_error_t actor_process_receive_message(actor_process_t process, actor_messa
     return actor_message_queue_get(process->message_queue, message, timeout);
 }
 
+// receive up to max messages
+actor_error_t actor_process_receive_messages(actor_process_t process,
+    actor_message_t* messages, actor_size_t max, actor_size_t* count,
+    actor_time_t timeout) {
+    // check for correct input, reactive processes get messages by handler
+    if ((process == NULL) || (timeout < 0.0) || (messages == NULL) ||
+        (count == NULL) || process->reactive) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // get messages
+    return actor_message_queue_get_batch(process->message_queue, messages,
+        max, count, timeout);
+}
+
+// selective message receive
+actor_error_t actor_process_receive_matching_message(actor_process_t process,
+    actor_message_t* message, actor_message_predicate_t predicate,
+    actor_time_t timeout) {
+    // check for correct input, reactive processes get messages by handler
+    if ((process == NULL) || (timeout < 0.0) || (message == NULL) ||
+        (predicate == NULL) || process->reactive) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // get matching message
+    return actor_message_queue_get_match(process->message_queue, message,
+        predicate, timeout);
+}
+
+// receive reply of call
+actor_error_t actor_process_receive_reply(actor_process_t process,
+    actor_message_t* message, unsigned int correlation_id, actor_time_t timeout) {
+    // check for correct input, reactive processes get messages by handler
+    if ((process == NULL) || (timeout < 0.0) || (message == NULL) ||
+        (correlation_id == 0) || process->reactive) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // messages saved before the request was sent cannot be its reply
+    return actor_message_queue_get_new_match(process->message_queue, message,
+        ^bool(actor_message_t candidate) {
+            return candidate->reply &&
+                (candidate->correlation_id == correlation_id);
+        }, timeout);
+}
+
 // sleep
 actor_error_t actor_process_sleep(actor_process_t process, actor_time_t time) {
-    // check for correct input
-    if ((process == NULL) || (time < 0.0)) {
+    // check for correct input, reactive processes must not block
+    if ((process == NULL) || (time < 0.0) || process->reactive) {
         return ACTOR_ERROR_INVALUE;
     }
 
+    // park green process until deadline, a stale unpark wakes it up early
+    if (process->task != NULL) {
+        actor_time_t deadline = actor_process_now() + time;
+
+        while (actor_scheduler_task_park(process->task, time) !=
+            ACTOR_ERROR_TIMEOUT) {
+            time = deadline - actor_process_now();
+            if (time <= 0.0) {
+                break;
+            }
+        }
+
+        return ACTOR_SUCCESS;
+    }
+
     // wait for timeout
     dispatch_semaphore_wait(process->sleep_semaphore,
         dispatch_time(DISPATCH_TIME_NOW,
@@ -134,6 +211,19 @@ actor_error_t actor_process_sleep(actor_process_t process, actor_time_t time) {
     return ACTOR_SUCCESS;
 }
 
+// stop reactive process
+actor_error_t actor_process_stop(actor_process_t process) {
+    // check valid process
+    if ((process == NULL) || !process->reactive) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // stop after current handler call
+    process->stopped = true;
+
+    return ACTOR_SUCCESS;
+}
+
 // link
 actor_error_t actor_process_link(actor_process_t process,
     actor_node_id_t supervisor_nid, actor_process_id_t supervisor_pid) {
@@ -0,0 +1,877 @@
+// libactor
+//
+// Implementation of an erlang style actor model using libdispatch
+// Copyright (C) 2012  Patrik Gebhardt
+// Contact: patrik.gebhardt@rub.de
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// ucontext routines require _XOPEN_SOURCE on OS X
+#ifdef __APPLE__
+#define _XOPEN_SOURCE 600
+#endif
+
+#include <ucontext.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../include/actor.h"
+
+// task states
+#define ACTOR_SCHEDULER_TASK_RUNNING    (0)
+#define ACTOR_SCHEDULER_TASK_PARKED     (1)
+#define ACTOR_SCHEDULER_TASK_NOTIFIED   (2)
+#define ACTOR_SCHEDULER_TASK_TIMED      (3)
+
+// requests of task to its worker
+#define ACTOR_SCHEDULER_REQUEST_NONE    (0)
+#define ACTOR_SCHEDULER_REQUEST_PARK    (1)
+#define ACTOR_SCHEDULER_REQUEST_EXIT    (2)
+
+// task struct
+struct actor_scheduler_task_s {
+    struct actor_scheduler_task_s* next;
+    struct actor_scheduler_task_s* live_previous;
+    struct actor_scheduler_task_s* live_next;
+    actor_scheduler_t scheduler;
+    actor_scheduler_function_t function;
+    actor_scheduler_function_t release_function;
+    void* context;
+    ucontext_t machine_context;
+    void* stack;
+    size_t stack_size;
+    long state;
+    int request;
+    actor_time_t timeout;
+    actor_timer_s timer;
+    bool timed_out;
+};
+
+// worker struct
+typedef struct {
+    actor_scheduler_t scheduler;
+    actor_scheduler_deque_t deque;
+    actor_size_t index;
+    unsigned int seed;
+    ucontext_t machine_context;
+    actor_scheduler_task_t task;
+} actor_scheduler_worker_s;
+typedef actor_scheduler_worker_s* actor_scheduler_worker_t;
+
+// worker of calling thread
+static __thread actor_scheduler_worker_t actor_scheduler_worker = NULL;
+
+// get worker of calling thread, never inlined, because tasks may resume on
+// another thread and the thread local address must not be cached
+static actor_scheduler_worker_t __attribute__((noinline))
+    actor_scheduler_current_worker(void) {
+    return actor_scheduler_worker;
+}
+
+// push task to bottom of run queue, only called by owning worker
+static bool actor_scheduler_deque_push(actor_scheduler_deque_t deque,
+    actor_scheduler_task_t task) {
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+
+    // check for full run queue
+    if (bottom - top >= ACTOR_SCHEDULER_DEQUE_SIZE) {
+        return false;
+    }
+
+    // publish task before new bottom
+    __atomic_store_n(&deque->tasks[bottom & (ACTOR_SCHEDULER_DEQUE_SIZE - 1)],
+        task, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+
+    return true;
+}
+
+// pop task from bottom of run queue, only called by owning worker
+static actor_scheduler_task_t actor_scheduler_deque_pop(
+    actor_scheduler_deque_t deque) {
+    // reserve bottom task
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+    // check for empty run queue
+    if (top > bottom) {
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+
+        return NULL;
+    }
+
+    // get task
+    actor_scheduler_task_t task = __atomic_load_n(
+        &deque->tasks[bottom & (ACTOR_SCHEDULER_DEQUE_SIZE - 1)],
+        __ATOMIC_RELAXED);
+
+    // race with thieves for last task
+    if (top == bottom) {
+        if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false,
+            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            task = NULL;
+        }
+
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    }
+
+    return task;
+}
+
+// steal task from top of run queue of another worker
+static actor_scheduler_task_t actor_scheduler_deque_steal(
+    actor_scheduler_deque_t deque) {
+    long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+
+    // check for empty run queue
+    if (top >= bottom) {
+        return NULL;
+    }
+
+    // get task and claim it, give up on concurrent pop or steal
+    actor_scheduler_task_t task = __atomic_load_n(
+        &deque->tasks[top & (ACTOR_SCHEDULER_DEQUE_SIZE - 1)], __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false,
+        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return NULL;
+    }
+
+    return task;
+}
+
+// check for tasks in run queue, result is only a hint
+static bool actor_scheduler_deque_empty(actor_scheduler_deque_t deque) {
+    return __atomic_load_n(&deque->top, __ATOMIC_SEQ_CST) >=
+        __atomic_load_n(&deque->bottom, __ATOMIC_SEQ_CST);
+}
+
+// enqueue task, locked tells if the calling thread holds the scheduler lock
+static void actor_scheduler_enqueue(actor_scheduler_t scheduler,
+    actor_scheduler_task_t task, bool locked) {
+    task->next = NULL;
+
+    // keep task on the core of a calling worker
+    actor_scheduler_worker_t worker = actor_scheduler_current_worker();
+    if ((worker == NULL) || (worker->scheduler != scheduler) ||
+        !actor_scheduler_deque_push(worker->deque, task)) {
+        // inject task for all workers
+        if (!locked) {
+            pthread_mutex_lock(&scheduler->lock);
+        }
+
+        if (scheduler->inject_last == NULL) {
+            scheduler->inject_first = task;
+        }
+        else {
+            scheduler->inject_last->next = task;
+        }
+        scheduler->inject_last = task;
+        __atomic_add_fetch(&scheduler->inject_count, 1, __ATOMIC_SEQ_CST);
+
+        if (!locked) {
+            pthread_mutex_unlock(&scheduler->lock);
+        }
+    }
+
+    // wake up an idle worker, the fence orders the new task against the idle
+    // count, which idle workers increment before looking for tasks
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&scheduler->idle_count, __ATOMIC_SEQ_CST) > 0) {
+        if (!locked) {
+            pthread_mutex_lock(&scheduler->lock);
+        }
+
+        pthread_cond_signal(&scheduler->condition);
+
+        if (!locked) {
+            pthread_mutex_unlock(&scheduler->lock);
+        }
+    }
+}
+
+// wake up task with expired timeout, called by the timer wheel
+static void actor_scheduler_task_expire(void* context) {
+    actor_scheduler_task_t task = context;
+
+    // enqueue parked task
+    long expected = ACTOR_SCHEDULER_TASK_TIMED;
+    if (__atomic_compare_exchange_n(&task->state, &expected,
+        ACTOR_SCHEDULER_TASK_RUNNING, false, __ATOMIC_SEQ_CST,
+        __ATOMIC_SEQ_CST)) {
+        task->timed_out = true;
+        actor_scheduler_enqueue(task->scheduler, task, false);
+
+        return;
+    }
+
+    // notify task, which is about to park, but only report the timeout, if
+    // the task was not notified by unpark before, unpark resets both, if it
+    // has already won the task, the remove of the timer by unpark or park
+    // waits for this function to return
+    expected = ACTOR_SCHEDULER_TASK_RUNNING;
+    if (__atomic_compare_exchange_n(&task->state, &expected,
+        ACTOR_SCHEDULER_TASK_NOTIFIED, false, __ATOMIC_SEQ_CST,
+        __ATOMIC_SEQ_CST)) {
+        task->timed_out = true;
+    }
+}
+
+// free task memory
+static void actor_scheduler_task_release(actor_scheduler_task_t task) {
+    if (task->stack != NULL) {
+        munmap(task->stack, task->stack_size);
+    }
+
+    free(task);
+}
+
+// add task to live tasks of its scheduler
+static void actor_scheduler_task_link(actor_scheduler_task_t task) {
+    actor_scheduler_t scheduler = task->scheduler;
+
+    pthread_mutex_lock(&scheduler->lock);
+    task->live_previous = NULL;
+    task->live_next = scheduler->tasks;
+    if (scheduler->tasks != NULL) {
+        scheduler->tasks->live_previous = task;
+    }
+    scheduler->tasks = task;
+    pthread_mutex_unlock(&scheduler->lock);
+}
+
+// remove task from live tasks of its scheduler
+static void actor_scheduler_task_unlink(actor_scheduler_task_t task) {
+    actor_scheduler_t scheduler = task->scheduler;
+
+    pthread_mutex_lock(&scheduler->lock);
+    if (task->live_previous != NULL) {
+        task->live_previous->live_next = task->live_next;
+    }
+    else {
+        scheduler->tasks = task->live_next;
+    }
+    if (task->live_next != NULL) {
+        task->live_next->live_previous = task->live_previous;
+    }
+    pthread_mutex_unlock(&scheduler->lock);
+}
+
+// entry point of every task
+static void actor_scheduler_task_main(void) {
+    // get task
+    actor_scheduler_task_t task = actor_scheduler_current_worker()->task;
+
+    // call task function
+    task->function(task->context);
+
+    // exit task
+    task->request = ACTOR_SCHEDULER_REQUEST_EXIT;
+    swapcontext(&task->machine_context,
+        &actor_scheduler_current_worker()->machine_context);
+}
+
+// handle request of task after it switched back to its worker
+static void actor_scheduler_handle_request(actor_scheduler_t scheduler,
+    actor_scheduler_task_t task) {
+    // get request
+    int request = task->request;
+    task->request = ACTOR_SCHEDULER_REQUEST_NONE;
+
+    // free finished task
+    if (request == ACTOR_SCHEDULER_REQUEST_EXIT) {
+        actor_scheduler_task_unlink(task);
+        actor_scheduler_task_release(task);
+
+        return;
+    }
+
+    // check for park request
+    if (request != ACTOR_SCHEDULER_REQUEST_PARK) {
+        return;
+    }
+
+    // park task without timeout, unpark enqueues it without lock
+    long expected = ACTOR_SCHEDULER_TASK_RUNNING;
+    if (task->timeout < 0.0) {
+        if (!__atomic_compare_exchange_n(&task->state, &expected,
+            ACTOR_SCHEDULER_TASK_PARKED, false, __ATOMIC_SEQ_CST,
+            __ATOMIC_SEQ_CST)) {
+            // task was notified while switching
+            __atomic_store_n(&task->state, ACTOR_SCHEDULER_TASK_RUNNING,
+                __ATOMIC_SEQ_CST);
+            actor_scheduler_enqueue(scheduler, task, false);
+        }
+
+        return;
+    }
+
+    // park task with timeout, its timer is added before the task is parked,
+    // so that an expiry in between is seen by the exchange below
+    if (actor_timer_wheel_add(scheduler->timer_wheel, &task->timer,
+        task->timeout) != ACTOR_SUCCESS) {
+        // run task again, if timer cannot be registered
+        task->timed_out = true;
+        __atomic_store_n(&task->state, ACTOR_SCHEDULER_TASK_RUNNING,
+            __ATOMIC_SEQ_CST);
+        actor_scheduler_enqueue(scheduler, task, false);
+
+        return;
+    }
+
+    if (!__atomic_compare_exchange_n(&task->state, &expected,
+        ACTOR_SCHEDULER_TASK_TIMED, false, __ATOMIC_SEQ_CST,
+        __ATOMIC_SEQ_CST)) {
+        // task was notified or timed out while switching
+        actor_timer_wheel_remove(scheduler->timer_wheel, &task->timer);
+        __atomic_store_n(&task->state, ACTOR_SCHEDULER_TASK_RUNNING,
+            __ATOMIC_SEQ_CST);
+        actor_scheduler_enqueue(scheduler, task, false);
+    }
+}
+
+// check for runnable tasks, called with lock held
+static bool actor_scheduler_has_work(actor_scheduler_t scheduler) {
+    if (scheduler->inject_first != NULL) {
+        return true;
+    }
+
+    for (actor_size_t i = 0; i < scheduler->deque_count; i++) {
+        if (!actor_scheduler_deque_empty(&scheduler->deques[i])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// get next task for worker
+static actor_scheduler_task_t actor_scheduler_next_task(
+    actor_scheduler_t scheduler, actor_scheduler_worker_t worker) {
+    // take task of own run queue
+    actor_scheduler_task_t task = actor_scheduler_deque_pop(worker->deque);
+    if (task != NULL) {
+        return task;
+    }
+
+    // take injected task
+    if (__atomic_load_n(&scheduler->inject_count, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&scheduler->lock);
+
+        task = scheduler->inject_first;
+        if (task != NULL) {
+            scheduler->inject_first = task->next;
+            if (scheduler->inject_first == NULL) {
+                scheduler->inject_last = NULL;
+            }
+            __atomic_sub_fetch(&scheduler->inject_count, 1, __ATOMIC_SEQ_CST);
+        }
+
+        pthread_mutex_unlock(&scheduler->lock);
+
+        if (task != NULL) {
+            return task;
+        }
+    }
+
+    // steal task of other worker, starting at a random victim
+    worker->seed = worker->seed * 1103515245 + 12345;
+    actor_size_t start = (worker->seed >> 16) % scheduler->deque_count;
+    for (actor_size_t i = 0; i < scheduler->deque_count; i++) {
+        actor_size_t victim = (start + i) % scheduler->deque_count;
+        if (victim == worker->index) {
+            continue;
+        }
+
+        task = actor_scheduler_deque_steal(&scheduler->deques[victim]);
+        if (task != NULL) {
+            return task;
+        }
+    }
+
+    return NULL;
+}
+
+// wait for tasks
+static void actor_scheduler_idle(actor_scheduler_t scheduler) {
+    pthread_mutex_lock(&scheduler->lock);
+
+    // announce idle worker before looking for tasks
+    __atomic_add_fetch(&scheduler->idle_count, 1, __ATOMIC_SEQ_CST);
+
+    // timeouts are enqueued by the timer wheel
+    while (scheduler->running && !actor_scheduler_has_work(scheduler)) {
+        pthread_cond_wait(&scheduler->condition, &scheduler->lock);
+    }
+
+    __atomic_sub_fetch(&scheduler->idle_count, 1, __ATOMIC_SEQ_CST);
+
+    pthread_mutex_unlock(&scheduler->lock);
+}
+
+// worker thread
+static void* actor_scheduler_worker_main(void* context) {
+    actor_scheduler_deque_t deque = context;
+    actor_scheduler_t scheduler = deque->scheduler;
+
+    // init worker
+    actor_scheduler_worker_s worker;
+    worker.scheduler = scheduler;
+    worker.deque = deque;
+    worker.index = deque - scheduler->deques;
+    worker.seed = (unsigned int)worker.index + 1;
+    worker.task = NULL;
+    actor_scheduler_worker = &worker;
+
+    // run loop
+    while (__atomic_load_n(&scheduler->running, __ATOMIC_SEQ_CST)) {
+        // get next task
+        actor_scheduler_task_t task = actor_scheduler_next_task(scheduler,
+            &worker);
+
+        // wait for tasks
+        if (task == NULL) {
+            actor_scheduler_idle(scheduler);
+
+            continue;
+        }
+
+        // run job on worker stack, it may release itself
+        if (task->stack == NULL) {
+            task->function(task->context);
+
+            continue;
+        }
+
+        // run task until it parks or exits
+        worker.task = task;
+        swapcontext(&worker.machine_context, &task->machine_context);
+        worker.task = NULL;
+
+        // handle request of task
+        actor_scheduler_handle_request(scheduler, task);
+    }
+
+    return NULL;
+}
+
+// create scheduler
+actor_error_t actor_scheduler_create(actor_scheduler_t* schedulerPointer,
+    actor_size_t worker_count, actor_timer_wheel_t timer_wheel) {
+    // check valid input
+    if ((schedulerPointer == NULL) || (timer_wheel == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // init scheduler pointer to NULL
+    *schedulerPointer = NULL;
+
+    // use one worker per core
+    if (worker_count == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        worker_count = cores > 0 ? (actor_size_t)cores : 1;
+    }
+
+    // create scheduler struct
+    actor_scheduler_t scheduler = malloc(sizeof(actor_scheduler_s));
+
+    // check success
+    if (scheduler == NULL) {
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // init struct
+    scheduler->workers = NULL;
+    scheduler->worker_count = 0;
+    scheduler->deques = NULL;
+    scheduler->deque_count = 0;
+    scheduler->inject_first = NULL;
+    scheduler->inject_last = NULL;
+    scheduler->inject_count = 0;
+    scheduler->idle_count = 0;
+    scheduler->tasks = NULL;
+    scheduler->timer_wheel = timer_wheel;
+    scheduler->running = true;
+    pthread_mutex_init(&scheduler->lock, NULL);
+    pthread_cond_init(&scheduler->condition, NULL);
+
+    // create worker array
+    scheduler->workers = malloc(sizeof(pthread_t) * worker_count);
+
+    // check success
+    if (scheduler->workers == NULL) {
+        // release scheduler
+        actor_scheduler_release(&scheduler);
+
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // create run queues
+    scheduler->deques = malloc(sizeof(actor_scheduler_deque_s) * worker_count);
+
+    // check success
+    if (scheduler->deques == NULL) {
+        // release scheduler
+        actor_scheduler_release(&scheduler);
+
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    for (actor_size_t i = 0; i < worker_count; i++) {
+        actor_scheduler_deque_t deque = &scheduler->deques[i];
+        deque->scheduler = scheduler;
+        deque->top = 0;
+        deque->bottom = 0;
+        deque->tasks = malloc(sizeof(actor_scheduler_task_t) *
+            ACTOR_SCHEDULER_DEQUE_SIZE);
+
+        // check success
+        if (deque->tasks == NULL) {
+            // release scheduler
+            actor_scheduler_release(&scheduler);
+
+            return ACTOR_ERROR_MEMORY;
+        }
+
+        scheduler->deque_count++;
+    }
+
+    // start workers
+    for (actor_size_t i = 0; i < worker_count; i++) {
+        if (pthread_create(&scheduler->workers[i], NULL,
+            actor_scheduler_worker_main, &scheduler->deques[i]) != 0) {
+            // release scheduler
+            actor_scheduler_release(&scheduler);
+
+            return ACTOR_ERROR_DISPATCH;
+        }
+
+        scheduler->worker_count++;
+    }
+
+    // set scheduler pointer
+    *schedulerPointer = scheduler;
+
+    return ACTOR_SUCCESS;
+}
+
+// cleanup scheduler
+actor_error_t actor_scheduler_release(actor_scheduler_t* schedulerPointer) {
+    // check for valid scheduler
+    if ((schedulerPointer == NULL) || (*schedulerPointer == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // get scheduler
+    actor_scheduler_t scheduler = *schedulerPointer;
+
+    // stop workers
+    pthread_mutex_lock(&scheduler->lock);
+    __atomic_store_n(&scheduler->running, false, __ATOMIC_SEQ_CST);
+    pthread_cond_broadcast(&scheduler->condition);
+    pthread_mutex_unlock(&scheduler->lock);
+
+    for (actor_size_t i = 0; i < scheduler->worker_count; i++) {
+        pthread_join(scheduler->workers[i], NULL);
+    }
+
+    // take tasks, which never ran to completion, queued or parked
+    pthread_mutex_lock(&scheduler->lock);
+    actor_scheduler_task_t tasks = scheduler->tasks;
+    scheduler->tasks = NULL;
+    pthread_mutex_unlock(&scheduler->lock);
+
+    // free them after their owners released the contexts
+    while (tasks != NULL) {
+        actor_scheduler_task_t task = tasks;
+        tasks = task->live_next;
+
+        actor_timer_wheel_remove(scheduler->timer_wheel, &task->timer);
+        if (task->release_function != NULL) {
+            task->release_function(task->context);
+        }
+        actor_scheduler_task_release(task);
+    }
+
+    // free run queues
+    for (actor_size_t i = 0; i < scheduler->deque_count; i++) {
+        free(scheduler->deques[i].tasks);
+    }
+
+    // free memory
+    if (scheduler->workers != NULL) {
+        free(scheduler->workers);
+    }
+    if (scheduler->deques != NULL) {
+        free(scheduler->deques);
+    }
+    pthread_mutex_destroy(&scheduler->lock);
+    pthread_cond_destroy(&scheduler->condition);
+    free(scheduler);
+
+    // set scheduler pointer to NULL
+    *schedulerPointer = NULL;
+
+    return ACTOR_SUCCESS;
+}
+
+// create task
+actor_error_t actor_scheduler_task_create(actor_scheduler_t scheduler,
+    actor_scheduler_task_t* taskPointer, actor_scheduler_function_t function,
+    actor_scheduler_function_t release_function, void* context) {
+    // check input
+    if ((scheduler == NULL) || (taskPointer == NULL) || (function == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // init task pointer to NULL
+    *taskPointer = NULL;
+
+    // create task struct
+    actor_scheduler_task_t task = malloc(sizeof(struct actor_scheduler_task_s));
+
+    // check success
+    if (task == NULL) {
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // init struct
+    task->next = NULL;
+    task->live_previous = NULL;
+    task->live_next = NULL;
+    task->scheduler = scheduler;
+    task->function = function;
+    task->release_function = release_function;
+    task->context = context;
+    task->stack = NULL;
+    task->stack_size = ACTOR_SCHEDULER_STACK_SIZE;
+    task->state = ACTOR_SCHEDULER_TASK_RUNNING;
+    task->request = ACTOR_SCHEDULER_REQUEST_NONE;
+    task->timeout = ACTOR_SCHEDULER_FOREVER;
+    actor_timer_init(&task->timer, actor_scheduler_task_expire, NULL, task);
+    task->timed_out = false;
+
+    // create stack, lowest page guards against overflow
+    task->stack = mmap(NULL, task->stack_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANON, -1, 0);
+
+    // check success
+    if (task->stack == MAP_FAILED) {
+        task->stack = NULL;
+        actor_scheduler_task_release(task);
+
+        return ACTOR_ERROR_MEMORY;
+    }
+    mprotect(task->stack, (size_t)sysconf(_SC_PAGESIZE), PROT_NONE);
+
+    // create machine context
+    if (getcontext(&task->machine_context) != 0) {
+        actor_scheduler_task_release(task);
+
+        return ACTOR_ERROR_DISPATCH;
+    }
+    task->machine_context.uc_stack.ss_sp = task->stack;
+    task->machine_context.uc_stack.ss_size = task->stack_size;
+    task->machine_context.uc_link = NULL;
+    makecontext(&task->machine_context, actor_scheduler_task_main, 0);
+
+    // keep task until it finished
+    actor_scheduler_task_link(task);
+
+    // set task pointer
+    *taskPointer = task;
+
+    return ACTOR_SUCCESS;
+}
+
+// create job
+actor_error_t actor_scheduler_job_create(actor_scheduler_t scheduler,
+    actor_scheduler_task_t* jobPointer, actor_scheduler_function_t function,
+    actor_scheduler_function_t release_function, void* context) {
+    // check input
+    if ((scheduler == NULL) || (jobPointer == NULL) || (function == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // init job pointer to NULL
+    *jobPointer = NULL;
+
+    // create task struct without stack
+    actor_scheduler_task_t job = malloc(sizeof(struct actor_scheduler_task_s));
+
+    // check success
+    if (job == NULL) {
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // init struct
+    job->next = NULL;
+    job->live_previous = NULL;
+    job->live_next = NULL;
+    job->scheduler = scheduler;
+    job->function = function;
+    job->release_function = release_function;
+    job->context = context;
+    job->stack = NULL;
+    job->stack_size = 0;
+    job->state = ACTOR_SCHEDULER_TASK_RUNNING;
+    job->request = ACTOR_SCHEDULER_REQUEST_NONE;
+    job->timeout = ACTOR_SCHEDULER_FOREVER;
+    actor_timer_init(&job->timer, actor_scheduler_task_expire, NULL, job);
+    job->timed_out = false;
+
+    // keep job until it is released
+    actor_scheduler_task_link(job);
+
+    // set job pointer
+    *jobPointer = job;
+
+    return ACTOR_SUCCESS;
+}
+
+// cleanup job
+actor_error_t actor_scheduler_job_release(actor_scheduler_task_t* jobPointer) {
+    // check for valid job
+    if ((jobPointer == NULL) || (*jobPointer == NULL) ||
+        ((*jobPointer)->stack != NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // free memory
+    actor_scheduler_task_unlink(*jobPointer);
+    actor_scheduler_task_release(*jobPointer);
+
+    // set job pointer to NULL
+    *jobPointer = NULL;
+
+    return ACTOR_SUCCESS;
+}
+
+// start task
+actor_error_t actor_scheduler_task_start(actor_scheduler_task_t task) {
+    // check input
+    if (task == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // enqueue task
+    actor_scheduler_enqueue(task->scheduler, task, false);
+
+    return ACTOR_SUCCESS;
+}
+
+// park calling task
+actor_error_t actor_scheduler_task_park(actor_scheduler_task_t task,
+    actor_time_t timeout) {
+    // check input
+    if (task == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // request parking
+    task->timed_out = false;
+    task->timeout = timeout;
+    task->request = ACTOR_SCHEDULER_REQUEST_PARK;
+
+    // switch to worker
+    swapcontext(&task->machine_context,
+        &actor_scheduler_current_worker()->machine_context);
+
+    // check for timeout
+    if (task->timed_out) {
+        return ACTOR_ERROR_TIMEOUT;
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// unpark task
+actor_error_t actor_scheduler_task_unpark(actor_scheduler_task_t task) {
+    // check input
+    if (task == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // get scheduler
+    actor_scheduler_t scheduler = task->scheduler;
+
+    while (true) {
+        long state = __atomic_load_n(&task->state, __ATOMIC_SEQ_CST);
+
+        // enqueue task parked without timeout
+        if (state == ACTOR_SCHEDULER_TASK_PARKED) {
+            long expected = ACTOR_SCHEDULER_TASK_PARKED;
+            if (__atomic_compare_exchange_n(&task->state, &expected,
+                ACTOR_SCHEDULER_TASK_RUNNING, false, __ATOMIC_SEQ_CST,
+                __ATOMIC_SEQ_CST)) {
+                actor_scheduler_enqueue(scheduler, task, false);
+
+                return ACTOR_SUCCESS;
+            }
+        }
+        // enqueue task parked with timeout and remove its timer first, so
+        // that it cannot be added again meanwhile
+        else if (state == ACTOR_SCHEDULER_TASK_TIMED) {
+            long expected = ACTOR_SCHEDULER_TASK_TIMED;
+            if (__atomic_compare_exchange_n(&task->state, &expected,
+                ACTOR_SCHEDULER_TASK_RUNNING, false, __ATOMIC_SEQ_CST,
+                __ATOMIC_SEQ_CST)) {
+                // undo expiry, which lost the race
+                if (actor_timer_wheel_remove(scheduler->timer_wheel,
+                    &task->timer) != ACTOR_SUCCESS) {
+                    task->timed_out = false;
+                    __atomic_store_n(&task->state,
+                        ACTOR_SCHEDULER_TASK_RUNNING, __ATOMIC_SEQ_CST);
+                }
+
+                actor_scheduler_enqueue(scheduler, task, false);
+
+                return ACTOR_SUCCESS;
+            }
+        }
+        // notify task, which is about to park
+        else if (state == ACTOR_SCHEDULER_TASK_RUNNING) {
+            long expected = ACTOR_SCHEDULER_TASK_RUNNING;
+            if (__atomic_compare_exchange_n(&task->state, &expected,
+                ACTOR_SCHEDULER_TASK_NOTIFIED, false, __ATOMIC_SEQ_CST,
+                __ATOMIC_SEQ_CST)) {
+                return ACTOR_SUCCESS;
+            }
+        }
+        // task is already notified
+        else {
+            return ACTOR_SUCCESS;
+        }
+    }
+}
+
+// get green task running on calling thread
+actor_error_t actor_scheduler_current_task(actor_scheduler_task_t* taskPointer,
+    bool* worker) {
+    // check input
+    if ((taskPointer == NULL) || (worker == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // jobs run on the worker stack without task
+    actor_scheduler_worker_t current = actor_scheduler_current_worker();
+    *worker = current != NULL;
+    *taskPointer = current != NULL ? current->task : NULL;
+
+    return ACTOR_SUCCESS;
+}
@@ -0,0 +1,514 @@
+// libactor
+//
+// Implementation of an erlang style actor model using libdispatch
+// Copyright (C) 2012  Patrik Gebhardt
+// Contact: patrik.gebhardt@rub.de
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <time.h>
+#include <limits.h>
+#include "../include/actor.h"
+
+// mask of slot index in a level
+#define ACTOR_TIMER_LEVEL_MASK ((unsigned long long)ACTOR_TIMER_LEVEL_SIZE - 1)
+
+// current time in nanoseconds, the monotonic clock is not affected by steps
+// of the wall clock
+static unsigned long long actor_timer_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (unsigned long long)now.tv_sec * NSEC_PER_SEC +
+        (unsigned long long)now.tv_nsec;
+}
+
+// rotate bitmap of occupied slots, so that bit 0 belongs to slot index
+static unsigned long long actor_timer_rotate(unsigned long long occupied,
+    unsigned long long index) {
+    if (index == 0) {
+        return occupied;
+    }
+
+    return (occupied >> index) | (occupied << (ACTOR_TIMER_LEVEL_SIZE - index));
+}
+
+// insert timer into slot of its level, called with lock held
+static void actor_timer_wheel_link(actor_timer_wheel_t wheel,
+    actor_timer_t timer) {
+    // overdue timers expire with the current tick
+    unsigned long long expires = timer->expires > wheel->current ?
+        timer->expires : wheel->current;
+    unsigned long long delta = expires - wheel->current;
+
+    // find lowest level, which reaches expiry, later timers wait in the
+    // farthest slot of the highest level
+    int level = 0;
+    while ((level < ACTOR_TIMER_LEVEL_COUNT - 1) &&
+        (delta >> (ACTOR_TIMER_LEVEL_BITS * (level + 1)) != 0)) {
+        level++;
+    }
+    if (delta >> (ACTOR_TIMER_LEVEL_BITS * ACTOR_TIMER_LEVEL_COUNT) != 0) {
+        expires = wheel->current +
+            (1ull << (ACTOR_TIMER_LEVEL_BITS * ACTOR_TIMER_LEVEL_COUNT)) - 1;
+    }
+    int slot = (int)((expires >> (ACTOR_TIMER_LEVEL_BITS * level)) &
+        ACTOR_TIMER_LEVEL_MASK);
+
+    // push timer to slot
+    actor_timer_t* head = &wheel->slots[level][slot];
+    timer->next = *head;
+    if (timer->next != NULL) {
+        timer->next->link = &timer->next;
+    }
+    timer->link = head;
+    *head = timer;
+    timer->level = level;
+    timer->slot = slot;
+    wheel->occupied[level] |= 1ull << slot;
+    wheel->count++;
+}
+
+// remove timer from its slot or the expired list, called with lock held
+static void actor_timer_wheel_unlink(actor_timer_wheel_t wheel,
+    actor_timer_t timer) {
+    *timer->link = timer->next;
+    if (timer->next != NULL) {
+        timer->next->link = timer->link;
+    }
+    if ((timer->level >= 0) &&
+        (wheel->slots[timer->level][timer->slot] == NULL)) {
+        wheel->occupied[timer->level] &= ~(1ull << timer->slot);
+    }
+    timer->next = NULL;
+    timer->link = NULL;
+    wheel->count--;
+}
+
+// take all timers of slot, called with lock held
+static actor_timer_t actor_timer_wheel_take(actor_timer_wheel_t wheel,
+    int level, int slot) {
+    actor_timer_t timers = wheel->slots[level][slot];
+
+    wheel->slots[level][slot] = NULL;
+    wheel->occupied[level] &= ~(1ull << slot);
+
+    return timers;
+}
+
+// get next tick, which expires timers or moves them down, called with lock
+// held
+static unsigned long long actor_timer_wheel_next(actor_timer_wheel_t wheel) {
+    unsigned long long next = ULLONG_MAX;
+
+    // check for timers
+    if (wheel->count == 0) {
+        return next;
+    }
+
+    for (int level = 0; level < ACTOR_TIMER_LEVEL_COUNT; level++) {
+        if (wheel->occupied[level] == 0) {
+            continue;
+        }
+
+        // slots of a level are handled at the start of their span, the
+        // slot of the current tick is still pending
+        int shift = ACTOR_TIMER_LEVEL_BITS * level;
+        unsigned long long block = (wheel->current + (1ull << shift) - 1) >>
+            shift;
+        unsigned long long occupied = actor_timer_rotate(wheel->occupied[level],
+            block & ACTOR_TIMER_LEVEL_MASK);
+        unsigned long long tick = (block +
+            (unsigned long long)__builtin_ctzll(occupied)) << shift;
+
+        if (tick < next) {
+            next = tick;
+        }
+    }
+
+    return next;
+}
+
+// handle current tick, called with lock held
+static void actor_timer_wheel_tick(actor_timer_wheel_t wheel) {
+    // move timers of upper levels down, once the level below has turned
+    for (int level = 1; level < ACTOR_TIMER_LEVEL_COUNT; level++) {
+        int shift = ACTOR_TIMER_LEVEL_BITS * level;
+        if ((wheel->current & ((1ull << shift) - 1)) != 0) {
+            break;
+        }
+
+        actor_timer_t timer = actor_timer_wheel_take(wheel, level,
+            (int)((wheel->current >> shift) & ACTOR_TIMER_LEVEL_MASK));
+        while (timer != NULL) {
+            actor_timer_t next = timer->next;
+            wheel->count--;
+            actor_timer_wheel_link(wheel, timer);
+            timer = next;
+        }
+    }
+
+    // move timers of current slot to expired list, they stay removable
+    actor_timer_t timer = actor_timer_wheel_take(wheel, 0,
+        (int)(wheel->current & ACTOR_TIMER_LEVEL_MASK));
+    if (timer != NULL) {
+        timer->link = &wheel->expired;
+        wheel->expired = timer;
+    }
+    for (; timer != NULL; timer = timer->next) {
+        timer->level = -1;
+    }
+
+    // timers added by timer functions belong to the next tick
+    wheel->current++;
+
+    // call timer functions without lock
+    while (wheel->expired != NULL) {
+        timer = wheel->expired;
+        actor_timer_wheel_unlink(wheel, timer);
+        wheel->firing = timer;
+
+        // the function may release a timer without period
+        bool periodic = timer->period != 0;
+
+        pthread_mutex_unlock(&wheel->lock);
+
+        timer->function(timer->context);
+
+        pthread_mutex_lock(&wheel->lock);
+
+        // add periodic timer again, unless the function did, a late wheel
+        // skips missed periods instead of catching up
+        if (periodic && (timer->link == NULL)) {
+            timer->expires += timer->period;
+            if (timer->expires < wheel->current) {
+                timer->expires = wheel->current;
+            }
+            actor_timer_wheel_link(wheel, timer);
+        }
+
+        wheel->firing = NULL;
+        if (wheel->firing_waiting > 0) {
+            pthread_cond_broadcast(&wheel->firing_condition);
+        }
+    }
+}
+
+// expire all timers up to tick now, called with lock held
+static void actor_timer_wheel_advance(actor_timer_wheel_t wheel,
+    unsigned long long now) {
+    // skip ticks without timers
+    unsigned long long next = actor_timer_wheel_next(wheel);
+    while (next <= now) {
+        wheel->current = next;
+        actor_timer_wheel_tick(wheel);
+
+        next = actor_timer_wheel_next(wheel);
+    }
+
+    if (wheel->current <= now) {
+        wheel->current = now + 1;
+    }
+}
+
+// wait on condition of wheel until deadline of the monotonic clock, called
+// with lock held
+static void actor_timer_wheel_wait(actor_timer_wheel_t wheel,
+    unsigned long long deadline) {
+#ifdef __APPLE__
+    // no monotonic condition clock, so wait relative to now
+    unsigned long long now = actor_timer_now();
+    if (deadline <= now) {
+        return;
+    }
+    deadline -= now;
+#endif
+
+    struct timespec time;
+    time.tv_sec = deadline / NSEC_PER_SEC;
+    time.tv_nsec = deadline % NSEC_PER_SEC;
+
+#ifdef __APPLE__
+    pthread_cond_timedwait_relative_np(&wheel->condition, &wheel->lock, &time);
+#else
+    pthread_cond_timedwait(&wheel->condition, &wheel->lock, &time);
+#endif
+}
+
+// thread of wheel
+static void* actor_timer_wheel_main(void* context) {
+    actor_timer_wheel_t wheel = context;
+
+    pthread_mutex_lock(&wheel->lock);
+
+    while (wheel->running) {
+        // expire timers
+        actor_timer_wheel_advance(wheel, actor_timer_now() / ACTOR_TIMER_TICK);
+
+        // wait for next tick with timers or new timer
+        wheel->wakeup = actor_timer_wheel_next(wheel);
+        if (wheel->wakeup != ULLONG_MAX) {
+            actor_timer_wheel_wait(wheel, wheel->wakeup * ACTOR_TIMER_TICK);
+        }
+        else {
+            pthread_cond_wait(&wheel->condition, &wheel->lock);
+        }
+    }
+
+    pthread_mutex_unlock(&wheel->lock);
+
+    return NULL;
+}
+
+// create timer wheel
+actor_error_t actor_timer_wheel_create(actor_timer_wheel_t* wheelPointer) {
+    // check valid wheel pointer
+    if (wheelPointer == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // init wheel pointer to NULL
+    *wheelPointer = NULL;
+
+    // create wheel struct
+    actor_timer_wheel_t wheel = malloc(sizeof(actor_timer_wheel_s));
+
+    // check success
+    if (wheel == NULL) {
+        return ACTOR_ERROR_MEMORY;
+    }
+
+    // init struct
+    for (int level = 0; level < ACTOR_TIMER_LEVEL_COUNT; level++) {
+        for (int slot = 0; slot < ACTOR_TIMER_LEVEL_SIZE; slot++) {
+            wheel->slots[level][slot] = NULL;
+        }
+        wheel->occupied[level] = 0;
+    }
+    wheel->current = actor_timer_now() / ACTOR_TIMER_TICK;
+    wheel->wakeup = ULLONG_MAX;
+    wheel->expired = NULL;
+    wheel->firing = NULL;
+    wheel->count = 0;
+    wheel->firing_waiting = 0;
+    wheel->started = false;
+    wheel->running = true;
+    pthread_mutex_init(&wheel->lock, NULL);
+    pthread_cond_init(&wheel->firing_condition, NULL);
+
+    // timed waits of the thread use the clock of the wheel
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+#ifndef __APPLE__
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+#endif
+    pthread_cond_init(&wheel->condition, &attributes);
+    pthread_condattr_destroy(&attributes);
+
+    // set wheel pointer
+    *wheelPointer = wheel;
+
+    return ACTOR_SUCCESS;
+}
+
+// stop expiring timers
+actor_error_t actor_timer_wheel_stop(actor_timer_wheel_t wheel) {
+    // check for valid wheel
+    if (wheel == NULL) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // stop thread
+    pthread_mutex_lock(&wheel->lock);
+    bool started = wheel->started;
+    wheel->running = false;
+    wheel->started = false;
+    pthread_cond_signal(&wheel->condition);
+    pthread_mutex_unlock(&wheel->lock);
+
+    if (started) {
+        pthread_join(wheel->thread, NULL);
+    }
+
+    return ACTOR_SUCCESS;
+}
+
+// cleanup timer wheel
+actor_error_t actor_timer_wheel_release(actor_timer_wheel_t* wheelPointer) {
+    // check for valid wheel
+    if ((wheelPointer == NULL) || (*wheelPointer == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // get wheel
+    actor_timer_wheel_t wheel = *wheelPointer;
+
+    // stop thread
+    actor_timer_wheel_stop(wheel);
+
+    // drop pending timers
+    for (int level = 0; level < ACTOR_TIMER_LEVEL_COUNT; level++) {
+        for (int slot = 0; slot < ACTOR_TIMER_LEVEL_SIZE; slot++) {
+            actor_timer_t timer = actor_timer_wheel_take(wheel, level, slot);
+
+            while (timer != NULL) {
+                actor_timer_t next = timer->next;
+                timer->next = NULL;
+                timer->link = NULL;
+
+                if (timer->drop_function != NULL) {
+                    timer->drop_function(timer->context);
+                }
+                timer = next;
+            }
+        }
+    }
+
+    // free memory
+    pthread_mutex_destroy(&wheel->lock);
+    pthread_cond_destroy(&wheel->condition);
+    pthread_cond_destroy(&wheel->firing_condition);
+    free(wheel);
+
+    // set wheel pointer to NULL
+    *wheelPointer = NULL;
+
+    return ACTOR_SUCCESS;
+}
+
+// init timer
+actor_error_t actor_timer_init(actor_timer_t timer,
+    actor_timer_function_t function, actor_timer_function_t drop_function,
+    void* context) {
+    // check input
+    if ((timer == NULL) || (function == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // init struct
+    timer->next = NULL;
+    timer->link = NULL;
+    timer->expires = 0;
+    timer->period = 0;
+    timer->level = 0;
+    timer->slot = 0;
+    timer->function = function;
+    timer->drop_function = drop_function;
+    timer->context = context;
+
+    return ACTOR_SUCCESS;
+}
+
+// add timer
+actor_error_t actor_timer_wheel_add(actor_timer_wheel_t wheel,
+    actor_timer_t timer, actor_time_t delay) {
+    // add timer without period
+    return actor_timer_wheel_add_periodic(wheel, timer, delay, 0.0);
+}
+
+// add periodic timer
+actor_error_t actor_timer_wheel_add_periodic(actor_timer_wheel_t wheel,
+    actor_timer_t timer, actor_time_t delay, actor_time_t period) {
+    // check input
+    if ((wheel == NULL) || (timer == NULL) || (timer->function == NULL) ||
+        (delay < 0.0) || (period < 0.0)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    // round expiry up to next tick, so that timers never expire early
+    unsigned long long now = actor_timer_now();
+    unsigned long long expires = (now + (unsigned long long)(delay *
+        (actor_time_t)NSEC_PER_SEC) + ACTOR_TIMER_TICK - 1) / ACTOR_TIMER_TICK;
+
+    // a period lasts at least one tick
+    unsigned long long ticks = ((unsigned long long)(period *
+        (actor_time_t)NSEC_PER_SEC) + ACTOR_TIMER_TICK - 1) / ACTOR_TIMER_TICK;
+    if ((period > 0.0) && (ticks == 0)) {
+        ticks = 1;
+    }
+
+    pthread_mutex_lock(&wheel->lock);
+
+    // start thread with first timer
+    if (!wheel->started && wheel->running) {
+        if (pthread_create(&wheel->thread, NULL, actor_timer_wheel_main,
+            wheel) != 0) {
+            pthread_mutex_unlock(&wheel->lock);
+
+            return ACTOR_ERROR_DISPATCH;
+        }
+
+        wheel->started = true;
+    }
+
+    // move pending timer
+    if (timer->link != NULL) {
+        actor_timer_wheel_unlink(wheel, timer);
+    }
+
+    // an empty wheel skips all ticks up to now, so that new timers are
+    // placed relative to the current time
+    if ((wheel->count == 0) && (wheel->current < now / ACTOR_TIMER_TICK)) {
+        wheel->current = now / ACTOR_TIMER_TICK;
+    }
+
+    // insert timer
+    timer->expires = expires;
+    timer->period = ticks;
+    actor_timer_wheel_link(wheel, timer);
+
+    // wake up thread for earlier tick
+    if (actor_timer_wheel_next(wheel) < wheel->wakeup) {
+        wheel->wakeup = 0;
+        pthread_cond_signal(&wheel->condition);
+    }
+
+    pthread_mutex_unlock(&wheel->lock);
+
+    return ACTOR_SUCCESS;
+}
+
+// remove pending timer
+actor_error_t actor_timer_wheel_remove(actor_timer_wheel_t wheel,
+    actor_timer_t timer) {
+    // check input
+    if ((wheel == NULL) || (timer == NULL)) {
+        return ACTOR_ERROR_INVALUE;
+    }
+
+    pthread_mutex_lock(&wheel->lock);
+
+    // wait for running timer function, unless it removes its own timer
+    if ((wheel->firing == timer) &&
+        !pthread_equal(pthread_self(), wheel->thread)) {
+        wheel->firing_waiting++;
+        while (wheel->firing == timer) {
+            pthread_cond_wait(&wheel->firing_condition, &wheel->lock);
+        }
+        wheel->firing_waiting--;
+    }
+
+    // check for pending timer
+    if (timer->link == NULL) {
+        pthread_mutex_unlock(&wheel->lock);
+
+        return ACTOR_ERROR_TIMEOUT;
+    }
+
+    actor_timer_wheel_unlink(wheel, timer);
+
+    pthread_mutex_unlock(&wheel->lock);
+
+    return ACTOR_SUCCESS;
+}